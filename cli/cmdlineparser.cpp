@@ -102,6 +102,8 @@ CmdLineParser::CmdLineParser(Settings *settings)
     , mShowVersion(false)
     , mShowErrorMessages(false)
     , mExitAfterPrint(false)
+    , mShardIndex(1)
+    , mShardCount(1)
 {
 }
 
@@ -301,6 +303,10 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
             else if (std::strcmp(argv[i], "--xml") == 0)
                 mSettings->xml = true;
 
+            // Write results in SARIF format
+            else if (std::strcmp(argv[i], "--sarif") == 0)
+                mSettings->sarif = true;
+
             // Define the XML file version (and enable XML output)
             else if (std::strncmp(argv[i], "--xml-version=", 14) == 0) {
                 const std::string numberString(argv[i]+14);
@@ -539,6 +545,48 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
                 mSettings->reportProgress = true;
             }
 
+            // Run as a server
+            else if (std::strncmp(argv[i], "--server=", 9) == 0) {
+                mServerSocket = argv[i] + 9;
+                if (mServerSocket.empty()) {
+                    printMessage("cppcheck: No socket path given to '--server' option.");
+                    return false;
+                }
+            }
+
+            // Check a part of the files
+            else if (std::strncmp(argv[i], "--shard=", 8) == 0) {
+                std::istringstream iss(8+argv[i]);
+                unsigned int index = 0, count = 0;
+                char slash = 0;
+                if (!(iss >> index >> slash >> count) || slash != '/' || !iss.eof()) {
+                    printMessage("cppcheck: argument to '--shard=' must be given as <index>/<count>.");
+                    return false;
+                }
+                if (index < 1 || index > count) {
+                    printMessage("cppcheck: argument to '--shard=' is out of range, <index> must be between 1 and <count>.");
+                    return false;
+                }
+                mShardIndex = index;
+                mShardCount = count;
+            }
+
+            // Combine the results of sharded runs
+            else if (std::strncmp(argv[i], "--merge-build-dir=", 18) == 0) {
+                std::string path = Path::fromNativeSeparators(argv[i] + 18);
+                if (path.empty()) {
+                    printMessage("cppcheck: No directory given to '--merge-build-dir' option.");
+                    return false;
+                }
+                if (path.size() > 1U && endsWith(path, '/'))
+                    path.erase(path.size() - 1U);
+                if (!FileLister::isDirectory(path)) {
+                    printMessage("cppcheck: Directory '" + path + "' specified by --merge-build-dir argument has to be existent.");
+                    return false;
+                }
+                mMergeBuildDirs.push_back(path);
+            }
+
             // --std
             else if (std::strcmp(argv[i], "--std=posix") == 0) {
                 mSettings->standards.posix = true;
@@ -697,6 +745,26 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
                 }
             }
 
+            // show memory usage..
+            else if (std::strncmp(argv[i], "--showmemory=", 13) == 0) {
+                const std::string showmemoryMode = argv[i] + 13;
+                if (showmemoryMode == "file")
+                    mSettings->showmemory = SHOWTIME_FILE;
+                else if (showmemoryMode == "summary")
+                    mSettings->showmemory = SHOWTIME_SUMMARY;
+                else if (showmemoryMode == "top5")
+                    mSettings->showmemory = SHOWTIME_TOP5;
+                else if (showmemoryMode.empty())
+                    mSettings->showmemory = SHOWTIME_NONE;
+                else {
+                    std::string message("cppcheck: error: unrecognized showmemory mode: \"");
+                    message += showmemoryMode;
+                    message += "\". Supported modes: file, summary, top5.";
+                    printMessage(message);
+                    return false;
+                }
+            }
+
 #ifdef HAVE_RULES
             // Rule given at command line
             else if (std::strncmp(argv[i], "--rule=", 7) == 0) {
@@ -828,6 +896,21 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
         printMessage("cppcheck: unusedFunction check can't be used with '-j' option. Disabling unusedFunction check.");
     }
 
+    // The whole program analysis is done when the build dirs of the shards
+    // are merged, without a build dir its results would be lost
+    if (mShardCount > 1 && mSettings->buildDir.empty()) {
+        printMessage("cppcheck: '--shard' requires '--cppcheck-build-dir', the whole program analysis is done when the build dirs are merged with '--merge-build-dir'.");
+        return false;
+    }
+
+#ifdef THREADING_MODEL_WIN
+    // The allocation counters are shared by all worker threads
+    if (mSettings->showmemory != SHOWTIME_NONE && mSettings->jobs > 1) {
+        printMessage("cppcheck: '--showmemory' can't be used with '-j' option on this platform.");
+        return false;
+    }
+#endif
+
     if (argc <= 1) {
         mShowHelp = true;
         mExitAfterPrint = true;
@@ -838,8 +921,13 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
         return true;
     }
 
+    if (mSettings->xml && mSettings->sarif) {
+        printMessage("cppcheck: '--xml' and '--sarif' can not be used together.");
+        return false;
+    }
+
     // Print error only if we have "real" command and expect files
-    if (!mExitAfterPrint && mPathNames.empty() && mSettings->project.fileSettings.empty()) {
+    if (!mExitAfterPrint && mPathNames.empty() && mSettings->project.fileSettings.empty() && mServerSocket.empty() && mMergeBuildDirs.empty()) {
         printMessage("cppcheck: No C or C++ source files found.");
         return false;
     }
@@ -851,6 +939,13 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
     return true;
 }
 
+bool CmdLineParser::isInShard(const std::string &filename, unsigned int shardIndex, unsigned int shardCount)
+{
+    // The hash of the path does not depend on the other files, so a file
+    // stays in its shard when files are added or removed
+    return fnv1a64(Path::fromNativeSeparators(filename)) % shardCount == shardIndex - 1U;
+}
+
 void CmdLineParser::printHelp()
 {
     std::cout << "Cppcheck - A tool for static C/C++ code analysis\n"
@@ -987,6 +1082,11 @@ void CmdLineParser::printHelp()
               "                         before skipping it. Default is '12'. If used together\n"
               "                         with '--force', the last option is the one that is\n"
               "                         effective.\n"
+              "    --merge-build-dir=<dir>\n"
+              "                         Report the results of runs with '--shard' and do\n"
+              "                         the whole program analysis for all of them. Give\n"
+              "                         this option once for each '--cppcheck-build-dir'\n"
+              "                         that the shards used. No files are checked.\n"
               "    --platform=<type>, --platform=<file>\n"
               "                         Specifies platform specific types and sizes. The\n"
               "                         available builtin platforms are:\n"
@@ -1025,6 +1125,29 @@ void CmdLineParser::printHelp()
               "    --rule-file=<file>   Use given rule file. For more information, see: \n"
               "                         http://sourceforge.net/projects/cppcheck/files/Articles/\n"
 #endif
+              "    --sarif              Write results in SARIF 2.1.0 format to error stream\n"
+              "                         (stderr).\n"
+              "    --server=<socket>    Keep running and check the files that clients request\n"
+              "                         through the UNIX socket <socket>. Libraries and\n"
+              "                         preprocessor data are reused between the requests.\n"
+              "                         The protocol is described in cli/serverexecutor.h.\n"
+              "    --shard=<index>/<count>\n"
+              "                         Only check the files of shard <index> (counting from\n"
+              "                         1) when the files are split into <count> parts.\n"
+              "                         Files are assigned to shards by a hash of their path\n"
+              "                         so the assignment is stable between runs. Each shard\n"
+              "                         needs its own '--cppcheck-build-dir', use\n"
+              "                         '--merge-build-dir' to combine the shards.\n"
+              "    --showmemory=<mode>  Show the allocations and the peak memory of each\n"
+              "                         phase (preprocessing, tokenizing, symbol database,\n"
+              "                         ValueFlow, checks) and the number of tokens, scopes,\n"
+              "                         variables and ValueFlow values. The modes are:\n"
+              "                          * file\n"
+              "                                 Show the usage of each file as it is checked\n"
+              "                          * summary\n"
+              "                                 Show the usage of all files at the end\n"
+              "                          * top5\n"
+              "                                 Show the 5 phases that allocate the most\n"
               "    --std=<id>           Set standard.\n"
               "                         The available options are:\n"
               "                          * posix\n"
@@ -86,6 +86,39 @@ public:
         return mExitAfterPrint;
     }
 
+    /**
+     * Return the socket path given with --server, empty if not given.
+     */
+    const std::string& getServerSocket() const {
+        return mServerSocket;
+    }
+
+    /**
+     * Return the shard to check, given with --shard. Counting starts at 1.
+     */
+    unsigned int getShardIndex() const {
+        return mShardIndex;
+    }
+
+    /**
+     * Return the number of shards, 1 if --shard is not given.
+     */
+    unsigned int getShardCount() const {
+        return mShardCount;
+    }
+
+    /**
+     * Is the file in the given shard? Counting starts at 1.
+     */
+    static bool isInShard(const std::string &filename, unsigned int shardIndex, unsigned int shardCount);
+
+    /**
+     * Return the build dirs given with --merge-build-dir.
+     */
+    const std::vector<std::string>& getMergeBuildDirs() const {
+        return mMergeBuildDirs;
+    }
+
     /**
      * Return a list of paths user wants to ignore.
      */
@@ -109,11 +142,15 @@ protected:
 private:
     std::vector<std::string> mPathNames;
     std::vector<std::string> mIgnoredPaths;
+    std::string mServerSocket;
+    std::vector<std::string> mMergeBuildDirs;
     Settings *mSettings;
     bool mShowHelp;
     bool mShowVersion;
     bool mShowErrorMessages;
     bool mExitAfterPrint;
+    unsigned int mShardIndex;
+    unsigned int mShardCount;
 };
 
 /// @}
@@ -28,10 +28,12 @@
 #include "path.h"
 #include "pathmatch.h"
 #include "preprocessor.h"
+#include "serverexecutor.h"
 #include "settings.h"
 #include "standards.h"
 #include "suppressions.h"
 #include "threadexecutor.h"
+#include "timer.h"
 #include "utils.h"
 #include "checkunusedfunctions.h"
 
@@ -79,7 +81,7 @@
 /*static*/ FILE* CppCheckExecutor::exceptionOutput = stdout;
 
 CppCheckExecutor::CppCheckExecutor()
-    : _settings(nullptr), latestProgressOutputTime(0), errorOutput(nullptr), errorlist(false)
+    : _settings(nullptr), latestProgressOutputTime(0), errorOutput(nullptr), errorlist(false), sarifResultCount(0), shardIndex(1), shardCount(1)
 {
 }
 
@@ -119,6 +121,11 @@ bool CppCheckExecutor::parseFromArgs(CppCheck *cppcheck, int argc, const char* c
         return false;
     }
 
+    serverSocket = parser.getServerSocket();
+    shardIndex = parser.getShardIndex();
+    shardCount = parser.getShardCount();
+    mergeBuildDirs = parser.getMergeBuildDirs();
+
     // Check that all include paths exist
     {
         for (std::list<std::string>::iterator iter = settings.includePaths.begin();
@@ -165,12 +172,29 @@ bool CppCheckExecutor::parseFromArgs(CppCheck *cppcheck, int argc, const char* c
             FileLister::recursiveAddFiles(_files, Path::toNativeSeparators(*iter), _settings->library.markupExtensions(), matcher);
     }
 
-    if (_files.empty() && settings.project.fileSettings.empty()) {
+    if (_files.empty() && settings.project.fileSettings.empty() && serverSocket.empty() && mergeBuildDirs.empty()) {
         std::cout << "cppcheck: error: could not find or open any of the paths given." << std::endl;
         if (!ignored.empty())
             std::cout << "cppcheck: Maybe all paths were ignored?" << std::endl;
         return false;
     }
+
+    // Only keep the files of this shard
+    if (shardCount > 1) {
+        for (std::map<std::string, std::size_t>::iterator i = _files.begin(); i != _files.end();) {
+            if (CmdLineParser::isInShard(i->first, shardIndex, shardCount))
+                ++i;
+            else
+                i = _files.erase(i);
+        }
+        for (std::list<ImportProject::FileSettings>::iterator fs = settings.project.fileSettings.begin(); fs != settings.project.fileSettings.end();) {
+            if (CmdLineParser::isInShard(fs->filename, shardIndex, shardCount))
+                ++fs;
+            else
+                fs = settings.project.fileSettings.erase(fs);
+        }
+    }
+
     return true;
 }
 
@@ -293,7 +317,7 @@ static void print_stacktrace(FILE* output, bool demangling, int maxdepth, bool l
 #endif
 }
 
-static const size_t MYSTACKSIZE = 16*1024+SIGSTKSZ; // wild guess about a reasonable buffer
+static const size_t MYSTACKSIZE = 16*1024+32768; // wild guess about a reasonable buffer
 static char mytstack[MYSTACKSIZE]= {0}; // alternative stack for signal handler
 static bool bStackBelowHeap=false; // lame attempt to locate heap vs. stack address space. See CppCheckExecutor::check_wrapper()
 
@@ -835,26 +859,50 @@ int CppCheckExecutor::check_internal(CppCheck& cppcheck, int /*argc*/, const cha
         return EXIT_FAILURE;
     }
 
+    // Check the configurations of a file that give the same preprocessor
+    // input once. This uses the defines of the libraries loaded above.
+    settings.project.removeEquivalentFileSettings(settings);
+
+    // Compile the --rule patterns once. The settings of each file, worker
+    // and server request are copies that share them.
+    cppcheck.compileRules();
+
+    if (!serverSocket.empty()) {
+        ServerExecutor server(serverSocket, settings, argv[0]);
+        return server.run();
+    }
+
     if (settings.reportProgress)
         latestProgressOutputTime = std::time(nullptr);
 
+    // Count the allocations from here on, see cli/newdelete.cpp
+    MemoryCounters::active = (settings.showmemory != SHOWTIME_NONE);
+
     if (!settings.outputFile.empty()) {
         errorOutput = new std::ofstream(settings.outputFile);
     }
 
     if (settings.xml) {
         reportErr(ErrorLogger::ErrorMessage::getXMLHeader());
+    } else if (settings.sarif) {
+        writeErr(ErrorLogger::ErrorMessage::getSarifHeader());
     }
 
-    if (!settings.buildDir.empty()) {
+    if (!settings.buildDir.empty() && mergeBuildDirs.empty()) {
         std::list<std::string> fileNames;
         for (std::map<std::string, std::size_t>::const_iterator i = _files.begin(); i != _files.end(); ++i)
             fileNames.push_back(i->first);
         AnalyzerInformation::writeFilesTxt(settings.buildDir, fileNames, settings.project.fileSettings);
     }
 
+    // Whole program analysis needs all the files, a shard only has a part of them
+    const bool wholeProgram = (shardCount == 1);
+
     unsigned int returnValue = 0;
-    if (settings.jobs == 1) {
+    if (!mergeBuildDirs.empty()) {
+        // Combine the results of sharded runs
+        returnValue = cppcheck.mergeBuildDirs(mergeBuildDirs);
+    } else if (settings.jobs == 1) {
         // Single process
         settings.jointSuppressionReport = true;
 
@@ -896,7 +944,7 @@ int CppCheckExecutor::check_internal(CppCheck& cppcheck, int /*argc*/, const cha
                 c++;
             }
         }
-        if (cppcheck.analyseWholeProgram())
+        if (wholeProgram && cppcheck.analyseWholeProgram())
             returnValue++;
     } else if (!ThreadExecutor::isEnabled()) {
         std::cout << "No thread support yet implemented for this platform." << std::endl;
@@ -906,9 +954,10 @@ int CppCheckExecutor::check_internal(CppCheck& cppcheck, int /*argc*/, const cha
         returnValue = executor.check();
     }
 
-    cppcheck.analyseWholeProgram(_settings->buildDir, _files);
+    if (wholeProgram && mergeBuildDirs.empty())
+        cppcheck.analyseWholeProgram(_settings->buildDir, _files);
 
-    if (settings.isEnabled(Settings::INFORMATION) || settings.checkConfiguration) {
+    if (wholeProgram && (settings.isEnabled(Settings::INFORMATION) || settings.checkConfiguration)) {
         const bool enableUnusedFunctionCheck = cppcheck.isUnusedFunctionCheckEnabled();
 
         if (settings.jointSuppressionReport) {
@@ -942,6 +991,8 @@ int CppCheckExecutor::check_internal(CppCheck& cppcheck, int /*argc*/, const cha
 
     if (settings.xml) {
         reportErr(ErrorLogger::ErrorMessage::getXMLFooter());
+    } else if (settings.sarif) {
+        writeErr(ErrorLogger::ErrorMessage::getSarifFooter());
     }
 
     _settings = nullptr;
@@ -977,14 +1028,18 @@ static inline std::string ansiToOEM(const std::string &msg, bool doConvert)
 void CppCheckExecutor::reportErr(const std::string &errmsg)
 {
     // Alert only about unique errors
-    if (_errorList.find(errmsg) != _errorList.end())
+    if (!_errorList.insert(fnv1a64(errmsg)).second)
         return;
 
-    _errorList.insert(errmsg);
+    writeErr(errmsg);
+}
+
+void CppCheckExecutor::writeErr(const std::string &errmsg)
+{
     if (errorOutput)
-        *errorOutput << errmsg << std::endl;
+        *errorOutput << errmsg << '\n';
     else {
-        std::cerr << ansiToOEM(errmsg, (_settings == nullptr) ? true : !_settings->xml) << std::endl;
+        std::cerr << ansiToOEM(errmsg, (_settings == nullptr) ? true : !(_settings->xml || _settings->sarif)) << std::endl;
     }
 }
 
@@ -1039,6 +1094,12 @@ void CppCheckExecutor::reportErr(const ErrorLogger::ErrorMessage &msg)
         reportOut(msg.toXML());
     } else if (_settings->xml) {
         reportErr(msg.toXML());
+    } else if (_settings->sarif) {
+        const std::string result = msg.toSarif();
+        if (_errorList.insert(fnv1a64(result)).second) {
+            // separate the results in the "results" array
+            writeErr((sarifResultCount++ == 0 ? "        " : "       ,") + result);
+        }
     } else {
         reportErr(msg.toString(_settings->verbose, _settings->templateFormat, _settings->templateLocation));
     }
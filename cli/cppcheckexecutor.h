@@ -21,11 +21,14 @@
 
 #include "errorlogger.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <ctime>
 #include <map>
-#include <set>
 #include <string>
+#include <unordered_set>
+#include <vector>
 
 class CppCheck;
 class Library;
@@ -110,10 +113,18 @@ protected:
 
     /**
      * Helper function to print out errors. Appends a line change.
+     * Messages that have already been printed are skipped.
      * @param errmsg String printed to error stream
      */
     void reportErr(const std::string &errmsg);
 
+    /**
+     * Print to the error stream without checking for duplicates.
+     * Appends a line change.
+     * @param errmsg String printed to error stream
+     */
+    void writeErr(const std::string &errmsg);
+
     /**
      * @brief Parse command line args and get settings and file lists
      * from there.
@@ -163,9 +174,11 @@ private:
     const Settings* _settings;
 
     /**
-     * Used to filter out duplicate error messages.
+     * Fingerprints of the printed messages, used to filter out duplicates.
+     * Only a 64-bit hash is kept per message so memory use stays small
+     * even when there are very many messages.
      */
-    std::set<std::string> _errorList;
+    std::unordered_set<std::uint64_t> _errorList;
 
     /**
      * Filename associated with size of file
@@ -191,6 +204,27 @@ private:
      * Has --errorlist been given?
      */
     bool errorlist;
+
+    /**
+     * Number of results written to the SARIF output
+     */
+    std::size_t sarifResultCount;
+
+    /**
+     * Socket path given with --server
+     */
+    std::string serverSocket;
+
+    /**
+     * Shard to check and number of shards, given with --shard
+     */
+    unsigned int shardIndex;
+    unsigned int shardCount;
+
+    /**
+     * Build dirs of sharded runs, given with --merge-build-dir
+     */
+    std::vector<std::string> mergeBuildDirs;
 };
 
 #endif // CPPCHECKEXECUTOR_H
@@ -25,6 +25,13 @@
 #include <cstddef>
 #include <cstring>
 
+static bool isIgnoredDirectory(const std::string &path, const PathMatch& ignored)
+{
+    // A directory mask like 'src/' matches everything below 'proj/src', so
+    // the directory is not read at all
+    return ignored.match(path) || ignored.match(path + '/');
+}
+
 #ifdef _WIN32
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -141,7 +148,7 @@ void FileLister::addFiles(std::map<std::string, std::size_t> &files, const std::
         } else {
             // Directory
             if (recursive) {
-                if (!ignored.match(fname))
+                if (!isIgnoredDirectory(fname, ignored))
                     FileLister::recursiveAddFiles(files, fname, extra, ignored);
             }
         }
@@ -175,6 +182,53 @@ bool FileLister::fileExists(const std::string &path)
 #include <sys/stat.h>
 
 
+static void addDirectory(std::map<std::string, std::size_t> &files,
+                         const std::string &path,
+                         const std::set<std::string> &extra,
+                         bool recursive,
+                         const PathMatch& ignored
+                        )
+{
+    DIR * dir = opendir(path.c_str());
+    if (!dir)
+        return;
+
+    std::string new_path;
+    new_path.reserve(path.length() + 100);// prealloc some memory to avoid constant new/deletes in loop
+
+    // The entries are looked up relative to the open directory, so the
+    // kernel does not resolve the whole path again for each of them
+    const int fd = dirfd(dir);
+    struct stat file_stat;
+    const dirent * dir_result;
+    while ((dir_result = readdir(dir)) != nullptr) {
+        if ((std::strcmp(dir_result->d_name, ".") == 0) ||
+            (std::strcmp(dir_result->d_name, "..") == 0))
+            continue;
+
+        new_path.assign(path);
+        new_path += '/';
+        new_path += dir_result->d_name;
+
+#if defined(_DIRENT_HAVE_D_TYPE) || defined(_BSD_SOURCE)
+        const bool path_is_directory = (dir_result->d_type == DT_DIR ||
+                                        (dir_result->d_type == DT_UNKNOWN && fstatat(fd, dir_result->d_name, &file_stat, 0) != -1 && (file_stat.st_mode & S_IFMT) == S_IFDIR));
+#else
+        const bool path_is_directory = (fstatat(fd, dir_result->d_name, &file_stat, 0) != -1 && (file_stat.st_mode & S_IFMT) == S_IFDIR);
+#endif
+        if (path_is_directory) {
+            if (recursive && !isIgnoredDirectory(new_path, ignored)) {
+                addDirectory(files, new_path, extra, recursive, ignored);
+            }
+        } else {
+            if (Path::acceptFile(new_path, extra) && !ignored.match(new_path) && fstatat(fd, dir_result->d_name, &file_stat, 0) != -1) {
+                files[new_path] = file_stat.st_size;
+            }
+        }
+    }
+    closedir(dir);
+}
+
 static void addFiles2(std::map<std::string, std::size_t> &files,
                       const std::string &path,
                       const std::set<std::string> &extra,
@@ -184,42 +238,9 @@ static void addFiles2(std::map<std::string, std::size_t> &files,
 {
     struct stat file_stat;
     if (stat(path.c_str(), &file_stat) != -1) {
-        if ((file_stat.st_mode & S_IFMT) == S_IFDIR) {
-            DIR * dir = opendir(path.c_str());
-            if (!dir)
-                return;
-
-            dirent entry;
-            dirent * dir_result;
-            std::string new_path;
-            new_path.reserve(path.length() + 100);// prealloc some memory to avoid constant new/deletes in loop
-
-            while ((readdir_r(dir, &entry, &dir_result) == 0) && (dir_result != nullptr)) {
-
-                if ((std::strcmp(dir_result->d_name, ".") == 0) ||
-                    (std::strcmp(dir_result->d_name, "..") == 0))
-                    continue;
-
-                new_path = path + '/' + dir_result->d_name;
-
-#if defined(_DIRENT_HAVE_D_TYPE) || defined(_BSD_SOURCE) 
-		bool path_is_directory = (dir_result->d_type == DT_DIR || (dir_result->d_type == DT_UNKNOWN && FileLister::isDirectory(new_path)));
-#else
-		bool path_is_directory = FileLister::isDirectory(new_path);
-#endif
-		if (path_is_directory) {
-                    if (recursive && !ignored.match(new_path)) {
-                        addFiles2(files, new_path, extra, recursive, ignored);
-                    }
-                } else {
-                    if (Path::acceptFile(new_path, extra) && !ignored.match(new_path)) {
-                        stat(new_path.c_str(), &file_stat);
-                        files[new_path] = file_stat.st_size;
-                    }
-                }
-            }
-            closedir(dir);
-        } else
+        if ((file_stat.st_mode & S_IFMT) == S_IFDIR)
+            addDirectory(files, path, extra, recursive, ignored);
+        else
             files[path] = file_stat.st_size;
     }
 }
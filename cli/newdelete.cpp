@@ -0,0 +1,105 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2018 Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Global operator new/delete that feed the MemoryCounters for --showmemory.
+// The size of a block is taken from the allocator, so nothing is added to
+// the blocks. On platforms where the allocator can't tell the size, the
+// default operators are used and --showmemory only shows the data counts.
+
+#include "timer.h"
+
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#define USABLE_SIZE(p) malloc_usable_size(p)
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#define USABLE_SIZE(p) malloc_size(p)
+#elif defined(_MSC_VER)
+#include <malloc.h>
+#define USABLE_SIZE(p) _msize(p)
+#endif
+
+#ifdef USABLE_SIZE
+
+static const bool memoryCountersSupported = (MemoryCounters::supported = true);
+
+static void *allocate(std::size_t size) noexcept
+{
+    void *p = std::malloc(size ? size : 1U);
+    if (p && MemoryCounters::active)
+        MemoryCounters::allocated(USABLE_SIZE(p));
+    return p;
+}
+
+static void deallocate(void *p) noexcept
+{
+    if (p && MemoryCounters::active)
+        MemoryCounters::deallocated(USABLE_SIZE(p));
+    std::free(p);
+}
+
+void *operator new(std::size_t size)
+{
+    void *p = allocate(size);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](std::size_t size)
+{
+    void *p = allocate(size);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept
+{
+    deallocate(p);
+}
+
+#endif
@@ -0,0 +1,291 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2018 Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "serverexecutor.h"
+
+#include "checkunusedfunctions.h"
+#include "cmdlineparser.h"
+#include "mathlib.h"
+#include "utils.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#ifdef SERVER_MODEL_UNIX
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+/** Largest "content" that a client can send, larger requests are refused */
+static const std::string::size_type maxContentSize = 64U * 1024U * 1024U;
+
+ServerExecutor::ServerExecutor(const std::string &socketPath, const Settings &settings, const char exename[])
+    : mSocketPath(socketPath), mSettings(settings), mExename(exename), mCppCheck(*this, true), mClient(-1)
+{
+}
+
+ServerExecutor::~ServerExecutor()
+{
+    //dtor
+}
+
+static std::string escape(const std::string &text)
+{
+    std::string ret;
+    ret.reserve(text.size());
+    for (const char c : text) {
+        if (c == '\\')
+            ret += "\\\\";
+        else if (c == '\n')
+            ret += "\\n";
+        else
+            ret += c;
+    }
+    return ret;
+}
+
+void ServerExecutor::reportOut(const std::string &outmsg)
+{
+    sendLine("out", outmsg);
+}
+
+void ServerExecutor::reportErr(const ErrorLogger::ErrorMessage &msg)
+{
+    const Settings &settings = mCppCheck.settings();
+    if (settings.xml)
+        sendLine("error", msg.toXML());
+    else if (settings.sarif)
+        sendLine("error", msg.toSarif());
+    else
+        sendLine("error", msg.toString(settings.verbose, settings.templateFormat, settings.templateLocation));
+}
+
+void ServerExecutor::reportInfo(const ErrorLogger::ErrorMessage &msg)
+{
+    reportErr(msg);
+}
+
+void ServerExecutor::process(const Request &request)
+{
+    if (request.path.empty()) {
+        sendLine("fail", "no file given");
+        return;
+    }
+
+    // Start from the command line settings. Only the libraries are
+    // copied, they are not loaded again.
+    Settings &settings = mCppCheck.settings();
+    settings = mSettings;
+    if (!request.options.empty()) {
+        std::vector<const char *> argv;
+        argv.push_back(mExename);
+        for (const std::string &option : request.options)
+            argv.push_back(option.c_str());
+        argv.push_back(request.path.c_str());
+        CmdLineParser parser(&settings);
+        if (!parser.parseFromArgs(static_cast<int>(argv.size()), argv.data())) {
+            sendLine("fail", "invalid options");
+            return;
+        }
+    }
+
+    CheckUnusedFunctions::clear();
+    const unsigned int result = request.hasContent ?
+                                mCppCheck.check(request.path, request.content) :
+                                mCppCheck.check(request.path);
+    mCppCheck.clearFileInfo();
+    sendLine("done", MathLib::toString(result));
+}
+
+bool ServerExecutor::serve(int fd)
+{
+    mClient = fd;
+    mBuffer.clear();
+
+    Request request;
+    std::string line;
+    while (readLine(line)) {
+        if (line == "quit")
+            return true;
+        if (line == "end") {
+            process(request);
+            request = Request();
+        } else if (line.compare(0, 6, "check ") == 0) {
+            request.path = line.substr(6);
+        } else if (line.compare(0, 7, "option ") == 0) {
+            request.options.push_back(line.substr(7));
+        } else if (line.compare(0, 8, "content ") == 0) {
+            const std::string size = line.substr(8);
+            if (!MathLib::isDec(size) || MathLib::isNegative(size)) {
+                sendLine("fail", "invalid content size '" + size + "'");
+                return false;
+            }
+            if (size.size() > 10U || MathLib::toULongNumber(size) > maxContentSize) {
+                sendLine("fail", "content size '" + size + "' is too large");
+                return false;
+            }
+            if (!readBytes(static_cast<std::string::size_type>(MathLib::toULongNumber(size)), request.content))
+                return false;
+            request.hasContent = true;
+        } else if (!line.empty()) {
+            sendLine("fail", "unknown request '" + line + "'");
+        }
+    }
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+////// This code is for platforms that support UNIX sockets only //////////////
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(SERVER_MODEL_UNIX)
+
+int ServerExecutor::run()
+{
+    // A client that disconnects early must not kill the server
+    std::signal(SIGPIPE, SIG_IGN);
+
+    struct sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (mSocketPath.empty() || mSocketPath.size() >= sizeof(addr.sun_path)) {
+        std::cout << "cppcheck: error: invalid server socket path '" << mSocketPath << "'." << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::strcpy(addr.sun_path, mSocketPath.c_str());
+
+    // Only a stale socket of an earlier server may be removed
+    struct stat st;
+    if (lstat(mSocketPath.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            std::cout << "cppcheck: error: '" << mSocketPath << "' exists and is not a socket." << std::endl;
+            return EXIT_FAILURE;
+        }
+        unlink(mSocketPath.c_str());
+    }
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        std::cout << "cppcheck: error: failed to create socket: " << std::strerror(errno) << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (bind(fd, reinterpret_cast<const struct sockaddr *>(&addr), sizeof(addr)) < 0 || listen(fd, 8) < 0) {
+        std::cout << "cppcheck: error: failed to listen on '" << mSocketPath << "': " << std::strerror(errno) << std::endl;
+        close(fd);
+        return EXIT_FAILURE;
+    }
+
+    bool quit = false;
+    while (!quit) {
+        const int client = accept(fd, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR)
+                continue;
+            std::cout << "cppcheck: error: accept failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+        quit = serve(client);
+        close(client);
+        mClient = -1;
+    }
+
+    close(fd);
+    unlink(mSocketPath.c_str());
+    return quit ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+bool ServerExecutor::fillBuffer()
+{
+    char buf[4096];
+    ssize_t len;
+    do {
+        len = read(mClient, buf, sizeof(buf));
+    } while (len < 0 && errno == EINTR);
+    if (len <= 0)
+        return false;
+    mBuffer.append(buf, static_cast<std::string::size_type>(len));
+    return true;
+}
+
+void ServerExecutor::sendLine(const char type[], const std::string &text)
+{
+    if (mClient < 0)
+        return;
+    const std::string line = std::string(type) + ' ' + escape(text) + '\n';
+    std::string::size_type pos = 0;
+    while (pos < line.size()) {
+        const ssize_t len = write(mClient, line.data() + pos, line.size() - pos);
+        if (len < 0 && errno == EINTR)
+            continue;
+        if (len <= 0) {
+            // The client is gone, drop the remaining output
+            mClient = -1;
+            return;
+        }
+        pos += static_cast<std::string::size_type>(len);
+    }
+}
+
+#else
+
+int ServerExecutor::run()
+{
+    std::cout << "cppcheck: error: --server is not supported on this platform." << std::endl;
+    return EXIT_FAILURE;
+}
+
+bool ServerExecutor::fillBuffer()
+{
+    return false;
+}
+
+void ServerExecutor::sendLine(const char[], const std::string &)
+{
+}
+
+#endif
+
+bool ServerExecutor::readLine(std::string &line)
+{
+    std::string::size_type pos;
+    while ((pos = mBuffer.find('\n')) == std::string::npos) {
+        if (!fillBuffer())
+            return false;
+    }
+    line = mBuffer.substr(0, pos);
+    mBuffer.erase(0, pos + 1);
+    if (endsWith(line, '\r'))
+        line.erase(line.size() - 1U);
+    return true;
+}
+
+bool ServerExecutor::readBytes(std::string::size_type size, std::string &data)
+{
+    while (mBuffer.size() < size) {
+        if (!fillBuffer())
+            return false;
+    }
+    data = mBuffer.substr(0, size);
+    mBuffer.erase(0, size);
+    return true;
+}
@@ -0,0 +1,128 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2018 Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SERVEREXECUTOR_H
+#define SERVEREXECUTOR_H
+
+#include "cppcheck.h"
+#include "errorlogger.h"
+#include "settings.h"
+
+#include <string>
+#include <vector>
+
+#if (defined(__GNUC__) || defined(__sun)) && !defined(__MINGW32__)
+#define SERVER_MODEL_UNIX
+#endif
+
+/// @addtogroup CLI
+/// @{
+
+/**
+ * Long-lived analysis process for editors and commit hooks. It listens
+ * on a local UNIX socket and checks one file per request, so the loaded
+ * libraries and the cached header configurations are reused between
+ * requests.
+ *
+ * A request is a sequence of text lines:
+ *   check <file>       file to check
+ *   option <arg>       command line option for this request only,
+ *                      e.g. "option --enable=style" (optional, repeatable)
+ *   content <size>     followed by <size> bytes that are checked instead
+ *                      of the file on disk (optional, at most 64 MB)
+ *   end                run the check
+ * A client can send several requests on one connection. "quit" stops
+ * the server. The socket path must not exist, or be the socket of an
+ * earlier server.
+ *
+ * Results are streamed back while the file is checked, one line each:
+ *   out <text>         progress output
+ *   error <text>       error message, formatted as on the command line
+ *   done <result>      the request is finished
+ *   fail <text>        the request could not be handled
+ * Newlines and backslashes in <text> are escaped as \n and \\.
+ */
+class ServerExecutor : public ErrorLogger {
+public:
+    /**
+     * @param socketPath path of the UNIX socket to listen on
+     * @param settings settings of the command line, with the libraries loaded
+     * @param exename argv[0], used for loading extra libraries
+     */
+    ServerExecutor(const std::string &socketPath, const Settings &settings, const char exename[]);
+    virtual ~ServerExecutor();
+
+    /**
+     * Accept clients and handle their requests until "quit" is received.
+     * @return EXIT_FAILURE if the socket could not be opened
+     */
+    int run();
+
+    /**
+     * Handle the requests of one connected client.
+     * @param fd socket of the client
+     * @return true if the client asked the server to quit
+     */
+    bool serve(int fd);
+
+    virtual void reportOut(const std::string &outmsg) override;
+    virtual void reportErr(const ErrorLogger::ErrorMessage &msg) override;
+    virtual void reportInfo(const ErrorLogger::ErrorMessage &msg) override;
+
+    /**
+     * @return true if the server is supported on this platform.
+     */
+    static bool isEnabled() {
+#ifdef SERVER_MODEL_UNIX
+        return true;
+#else
+        return false;
+#endif
+    }
+
+private:
+    struct Request {
+        Request() : hasContent(false) {}
+        std::string path;
+        std::vector<std::string> options;
+        std::string content;
+        bool hasContent;
+    };
+
+    /** Check the file of a complete request and send the results */
+    void process(const Request &request);
+
+    bool readLine(std::string &line);
+    bool readBytes(std::string::size_type size, std::string &data);
+    bool fillBuffer();
+    void sendLine(const char type[], const std::string &text);
+
+    const std::string mSocketPath;
+    const Settings mSettings;
+    const char * const mExename;
+
+    /** Kept alive between requests so its caches stay warm */
+    CppCheck mCppCheck;
+
+    int mClient;
+    std::string mBuffer;
+};
+
+/// @}
+
+#endif // SERVEREXECUTOR_H
@@ -24,6 +24,7 @@
 #include "importproject.h"
 #include "settings.h"
 #include "suppressions.h"
+#include "utils.h"
 
 #include <algorithm>
 #include <cerrno>
@@ -120,8 +121,7 @@ int ThreadExecutor::handleRead(int rpipe, unsigned int &result)
         if (!_settings.nomsg.isSuppressed(msg.toSuppressionsErrorMessage())) {
             // Alert only about unique errors
             std::string errmsg = msg.toString(_settings.verbose);
-            if (std::find(_errorList.begin(), _errorList.end(), errmsg) == _errorList.end()) {
-                _errorList.push_back(errmsg);
+            if (_errorList.insert(fnv1a64(errmsg)).second) {
                 if (type == REPORT_ERROR)
                     _errorLogger.reportErr(msg);
                 else
@@ -503,8 +503,7 @@ void ThreadExecutor::report(const ErrorLogger::ErrorMessage &msg, MessageType ms
     const std::string errmsg = msg.toString(_settings.verbose);
 
     EnterCriticalSection(&_errorSync);
-    if (std::find(_errorList.begin(), _errorList.end(), errmsg) == _errorList.end()) {
-        _errorList.push_back(errmsg);
+    if (_errorList.insert(fnv1a64(errmsg)).second) {
         reportError = true;
     }
     LeaveCriticalSection(&_errorSync);
@@ -23,9 +23,11 @@
 #include "importproject.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <list>
 #include <map>
 #include <string>
+#include <unordered_set>
 
 #if (defined(__GNUC__) || defined(__sun)) && !defined(__MINGW32__)
 #define THREADING_MODEL_FORK
@@ -83,11 +85,12 @@ private:
      */
     int handleRead(int rpipe, unsigned int &result);
     void writeToPipe(PipeSignal type, const std::string &data);
+    /** Fingerprints of the reported messages */
+    std::unordered_set<std::uint64_t> _errorList;
     /**
      * Write end of status pipe, different for each child.
      * Not used in master process.
      */
-    std::list<std::string> _errorList;
     int _wpipe;
 
     /**
@@ -119,7 +122,8 @@ private:
     std::size_t _totalFileSize;
     CRITICAL_SECTION _fileSync;
 
-    std::list<std::string> _errorList;
+    /** Fingerprints of the reported messages */
+    std::unordered_set<std::uint64_t> _errorList;
     CRITICAL_SECTION _errorSync;
 
     CRITICAL_SECTION _reportSync;
@@ -23,6 +23,7 @@
 #include "simplecpp.h"
 
 #include <algorithm>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <exception>
@@ -33,6 +34,9 @@
 #include <stack>
 #include <stdexcept>
 #include <utility>
+#if __cplusplus >= 201103L
+#include <unordered_map>
+#endif
 
 #ifdef SIMPLECPP_WINDOWS
 #include <windows.h>
@@ -187,15 +191,27 @@ void simplecpp::Token::printOut() const
     std::cout << std::endl;
 }
 
-simplecpp::TokenList::TokenList(std::vector<std::string> &filenames) : frontToken(NULL), backToken(NULL), files(filenames) {}
+simplecpp::TokenList::TokenList(std::vector<std::string> &filenames) : frontToken(NULL), backToken(NULL), files(filenames), datahash(0) {}
 
 simplecpp::TokenList::TokenList(std::istream &istr, std::vector<std::string> &filenames, const std::string &filename, OutputList *outputList)
-    : frontToken(NULL), backToken(NULL), files(filenames)
+    : frontToken(NULL), backToken(NULL), files(filenames), datahash(0)
 {
     readfile(istr,filename,outputList);
 }
 
-simplecpp::TokenList::TokenList(const TokenList &other) : frontToken(NULL), backToken(NULL), files(other.files)
+simplecpp::TokenList::TokenList(const unsigned char *data, std::size_t size, std::vector<std::string> &filenames, const std::string &filename, OutputList *outputList)
+    : frontToken(NULL), backToken(NULL), files(filenames), datahash(0)
+{
+    readfile(data,size,filename,outputList);
+}
+
+simplecpp::TokenList::TokenList(const char *data, std::size_t size, std::vector<std::string> &filenames, const std::string &filename, OutputList *outputList)
+    : frontToken(NULL), backToken(NULL), files(filenames), datahash(0)
+{
+    readfile(reinterpret_cast<const unsigned char *>(data),size,filename,outputList);
+}
+
+simplecpp::TokenList::TokenList(const TokenList &other) : frontToken(NULL), backToken(NULL), files(other.files), datahash(0)
 {
     *this = other;
 }
@@ -212,6 +228,7 @@ simplecpp::TokenList &simplecpp::TokenList::operator=(const TokenList &other)
         for (const Token *tok = other.cfront(); tok; tok = tok->next)
             push_back(new Token(*tok));
         sizeOfType = other.sizeOfType;
+        datahash = other.datahash;
     }
     return *this;
 }
@@ -225,6 +242,7 @@ void simplecpp::TokenList::clear()
         frontToken = next;
     }
     sizeOfType.clear();
+    datahash = 0;
 }
 
 void simplecpp::TokenList::push_back(Token *tok)
@@ -268,94 +286,217 @@ std::string simplecpp::TokenList::stringify() const
     return ret.str();
 }
 
-static unsigned char readChar(std::istream &istr, unsigned int bom)
-{
-    unsigned char ch = (unsigned char)istr.get();
+namespace {
+    /** Character classes used by the tokenizer, one table lookup per character */
+    enum CharClassBits {
+        CC_NAME    = 1, // [A-Za-z0-9_$]
+        CC_BLANK   = 2, // space, tab and other control characters except newlines
+        CC_NEWLINE = 4, // \r and \n
+        CC_STAR    = 8  // *
+    };
 
-    // For UTF-16 encoded files the BOM is 0xfeff/0xfffe. If the
-    // character is non-ASCII character then replace it with 0xff
-    if (bom == 0xfeff || bom == 0xfffe) {
-        const unsigned char ch2 = (unsigned char)istr.get();
-        const int ch16 = (bom == 0xfeff) ? (ch<<8 | ch2) : (ch2<<8 | ch);
-        ch = (unsigned char)((ch16 >= 0x80) ? 0xff : ch16);
+    class CharClassTable {
+    public:
+        CharClassTable() {
+            for (unsigned int c = 0; c < 256U; ++c) {
+                unsigned char bits = 0;
+                if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '$')
+                    bits |= CC_NAME;
+                if (c == '\r' || c == '\n')
+                    bits |= CC_NEWLINE;
+                else if (c <= ' ')
+                    bits |= CC_BLANK;
+                if (c == '*')
+                    bits |= CC_STAR;
+                table[c] = bits;
+            }
+        }
+        bool is(unsigned char c, unsigned char bits) const {
+            return (table[c] & bits) != 0;
+        }
+    private:
+        unsigned char table[256];
+    };
+
+    const CharClassTable charClass;
+}
+
+/**
+ * Character source for the tokenizer. Reads from a contiguous buffer and
+ * mimics the get/peek/unget/good semantics of std::istream, so the
+ * tokenizer behaves the same for streams and buffers without paying for
+ * the iostream machinery on every character.
+ */
+class simplecpp::TokenList::Stream {
+public:
+    Stream(const unsigned char *data, std::size_t size) : data(data), size(size), pos(0), eof(false), fail(false) {}
+
+    bool good() const {
+        return !eof && !fail;
     }
 
-    // Handling of newlines..
-    if (ch == '\r') {
-        ch = '\n';
-        if (bom == 0 && (char)istr.peek() == '\n')
-            (void)istr.get();
-        else if (bom == 0xfeff || bom == 0xfffe) {
-            int c1 = istr.get();
-            int c2 = istr.get();
-            int ch16 = (bom == 0xfeff) ? (c1<<8 | c2) : (c2<<8 | c1);
-            if (ch16 != '\n') {
-                istr.unget();
-                istr.unget();
-            }
+    int get() {
+        if (!good()) {
+            fail = true;
+            return EOF;
         }
+        if (pos >= size) {
+            eof = fail = true;
+            return EOF;
+        }
+        return data[pos++];
     }
 
-    return ch;
-}
+    int peek() {
+        if (!good()) {
+            fail = true;
+            return EOF;
+        }
+        if (pos >= size) {
+            eof = true;
+            return EOF;
+        }
+        return data[pos];
+    }
 
-static unsigned char peekChar(std::istream &istr, unsigned int bom)
-{
-    unsigned char ch = (unsigned char)istr.peek();
+    void unget() {
+        eof = false;
+        if (fail)
+            return;
+        if (pos == 0)
+            fail = true;
+        else
+            --pos;
+    }
+
+    unsigned char readChar(unsigned int bom) {
+        unsigned char ch = (unsigned char)get();
+
+        // For UTF-16 encoded files the BOM is 0xfeff/0xfffe. If the
+        // character is non-ASCII character then replace it with 0xff
+        if (bom == 0xfeff || bom == 0xfffe) {
+            const unsigned char ch2 = (unsigned char)get();
+            const int ch16 = (bom == 0xfeff) ? (ch<<8 | ch2) : (ch2<<8 | ch);
+            ch = (unsigned char)((ch16 >= 0x80) ? 0xff : ch16);
+        }
+
+        // Handling of newlines..
+        if (ch == '\r') {
+            ch = '\n';
+            if (bom == 0 && (char)peek() == '\n')
+                (void)get();
+            else if (bom == 0xfeff || bom == 0xfffe) {
+                int c1 = get();
+                int c2 = get();
+                int ch16 = (bom == 0xfeff) ? (c1<<8 | c2) : (c2<<8 | c1);
+                if (ch16 != '\n') {
+                    unget();
+                    unget();
+                }
+            }
+        }
 
-    // For UTF-16 encoded files the BOM is 0xfeff/0xfffe. If the
-    // character is non-ASCII character then replace it with 0xff
-    if (bom == 0xfeff || bom == 0xfffe) {
-        (void)istr.get();
-        const unsigned char ch2 = (unsigned char)istr.peek();
-        istr.unget();
-        const int ch16 = (bom == 0xfeff) ? (ch<<8 | ch2) : (ch2<<8 | ch);
-        ch = (unsigned char)((ch16 >= 0x80) ? 0xff : ch16);
+        return ch;
     }
 
-    // Handling of newlines..
-    if (ch == '\r')
-        ch = '\n';
+    unsigned char peekChar(unsigned int bom) {
+        unsigned char ch = (unsigned char)peek();
 
-    return ch;
-}
+        // For UTF-16 encoded files the BOM is 0xfeff/0xfffe. If the
+        // character is non-ASCII character then replace it with 0xff
+        if (bom == 0xfeff || bom == 0xfffe) {
+            (void)get();
+            const unsigned char ch2 = (unsigned char)peek();
+            unget();
+            const int ch16 = (bom == 0xfeff) ? (ch<<8 | ch2) : (ch2<<8 | ch);
+            ch = (unsigned char)((ch16 >= 0x80) ? 0xff : ch16);
+        }
 
-static void ungetChar(std::istream &istr, unsigned int bom)
-{
-    istr.unget();
-    if (bom == 0xfeff || bom == 0xfffe)
-        istr.unget();
-}
+        // Handling of newlines..
+        if (ch == '\r')
+            ch = '\n';
 
-static unsigned short getAndSkipBOM(std::istream &istr)
-{
-    const unsigned char ch1 = istr.peek();
+        return ch;
+    }
 
-    // The UTF-16 BOM is 0xfffe or 0xfeff.
-    if (ch1 >= 0xfe) {
-        unsigned short bom = ((unsigned char)istr.get() << 8);
-        if (istr.peek() >= 0xfe)
-            return bom | (unsigned char)istr.get();
-        return 0;
+    /**
+     * Append following characters to str as long as they belong to one of
+     * the given character classes. Only usable for 8-bit input (no BOM) where
+     * the characters do not need any translation.
+     */
+    std::size_t appendWhile(std::string &str, unsigned char bits) {
+        if (!good())
+            return 0;
+        const std::size_t start = pos;
+        while (pos < size && charClass.is(data[pos], bits))
+            ++pos;
+        str.append(reinterpret_cast<const char *>(data + start), pos - start);
+        return pos - start;
     }
 
-    // Skip UTF-8 BOM 0xefbbbf
-    if (ch1 == 0xef) {
-        (void)istr.get();
-        if (istr.get() == 0xbb && istr.peek() == 0xbf) {
-            (void)istr.get();
-        } else {
-            istr.unget();
-            istr.unget();
+    /** Same as appendWhile() but stops at the first character that belongs to one of the given character classes. */
+    std::size_t appendUntil(std::string &str, unsigned char bits) {
+        if (!good())
+            return 0;
+        const std::size_t start = pos;
+        while (pos < size && !charClass.is(data[pos], bits))
+            ++pos;
+        str.append(reinterpret_cast<const char *>(data + start), pos - start);
+        return pos - start;
+    }
+
+    /** Skip following blank characters and return how many were skipped. Only usable for 8-bit input. */
+    std::size_t skipBlanks() {
+        if (!good())
+            return 0;
+        const std::size_t start = pos;
+        while (pos < size && charClass.is(data[pos], CC_BLANK))
+            ++pos;
+        return pos - start;
+    }
+
+    void ungetChar(unsigned int bom) {
+        unget();
+        if (bom == 0xfeff || bom == 0xfffe)
+            unget();
+    }
+
+    unsigned short getAndSkipBOM() {
+        const unsigned char ch1 = (unsigned char)peek();
+
+        // The UTF-16 BOM is 0xfffe or 0xfeff.
+        if (ch1 >= 0xfe) {
+            unsigned short bom = ((unsigned char)get() << 8);
+            if (peek() >= 0xfe)
+                return bom | (unsigned char)get();
+            return 0;
+        }
+
+        // Skip UTF-8 BOM 0xefbbbf
+        if (ch1 == 0xef) {
+            (void)get();
+            if (get() == 0xbb && peek() == 0xbf) {
+                (void)get();
+            } else {
+                unget();
+                unget();
+            }
         }
+
+        return 0;
     }
 
-    return 0;
-}
+private:
+    const unsigned char * const data;
+    const std::size_t size;
+    std::size_t pos;
+    bool eof;
+    bool fail;
+};
 
 static bool isNameChar(unsigned char ch)
 {
-    return std::isalnum(ch) || ch == '_' || ch == '$';
+    return charClass.is(ch, CC_NAME);
 }
 
 static std::string escapeString(const std::string &str)
@@ -389,6 +530,39 @@ static bool isRawStringId(const std::string &str)
 }
 
 void simplecpp::TokenList::readfile(std::istream &istr, const std::string &filename, OutputList *outputList)
+{
+    // Read the whole stream at once, the tokenizer then works on the buffer
+    std::string buf;
+    char chunk[16384];
+    while (istr.read(chunk, sizeof(chunk)) || istr.gcount() > 0)
+        buf.append(chunk, (std::size_t)istr.gcount());
+    readfile(reinterpret_cast<const unsigned char *>(buf.data()), buf.size(), filename, outputList);
+}
+
+/** FNV-1a over 8 byte words, folded so that every byte affects the low bits */
+static unsigned long long hashData(const unsigned char *data, std::size_t size)
+{
+    unsigned long long hash = 0xcbf29ce484222325ULL ^ size;
+    std::size_t pos = 0;
+    for (; pos + 8U <= size; pos += 8U) {
+        unsigned long long word;
+        std::memcpy(&word, data + pos, 8U);
+        hash = (hash ^ word) * 0x100000001b3ULL;
+        hash ^= hash >> 32;
+    }
+    for (; pos < size; ++pos)
+        hash = (hash ^ data[pos]) * 0x100000001b3ULL;
+    return hash;
+}
+
+void simplecpp::TokenList::readfile(const unsigned char *data, std::size_t size, const std::string &filename, OutputList *outputList)
+{
+    datahash = hashData(data, size);
+    Stream stream(data, size);
+    readfile(stream, filename, outputList);
+}
+
+void simplecpp::TokenList::readfile(Stream &istr, const std::string &filename, OutputList *outputList)
 {
     std::stack<simplecpp::Location> loc;
 
@@ -396,14 +570,14 @@ void simplecpp::TokenList::readfile(std::istream &istr, const std::string &filen
 
     const Token *oldLastToken = NULL;
 
-    const unsigned short bom = getAndSkipBOM(istr);
+    const unsigned short bom = istr.getAndSkipBOM();
 
     Location location(files);
     location.fileIndex = fileIndex(filename);
     location.line = 1U;
     location.col  = 1U;
     while (istr.good()) {
-        unsigned char ch = readChar(istr,bom);
+        unsigned char ch = istr.readChar(bom);
         if (!istr.good())
             break;
         if (ch < ' ' && ch != '\t' && ch != '\n' && ch != '\r')
@@ -438,7 +612,7 @@ void simplecpp::TokenList::readfile(std::istream &istr, const std::string &filen
 
             if (oldLastToken != cback()) {
                 oldLastToken = cback();
-                const std::string lastline(lastLine());
+                const std::string lastline(lastLine(4)); // the directives below have at most 4 tokens
                 if (lastline == "# file %str%") {
                     loc.push(location);
                     location.fileIndex = fileIndex(cback()->str().substr(1U, cback()->str().size() - 2U));
@@ -467,6 +641,8 @@ void simplecpp::TokenList::readfile(std::istream &istr, const std::string &filen
 
         if (std::isspace(ch)) {
             location.col++;
+            if (bom == 0)
+                location.col += (unsigned int)istr.skipBlanks();
             continue;
         }
 
@@ -475,7 +651,7 @@ void simplecpp::TokenList::readfile(std::istream &istr, const std::string &filen
         if (cback() && cback()->location.line == location.line && cback()->previous && cback()->previous->op == '#' && (lastLine() == "# error" || lastLine() == "# warning")) {
             while (istr.good() && ch != '\r' && ch != '\n') {
                 currentToken += ch;
-                ch = readChar(istr, bom);
+                ch = istr.readChar(bom);
             }
             istr.unget();
             push_back(new Token(currentToken, location));
@@ -487,19 +663,23 @@ void simplecpp::TokenList::readfile(std::istream &istr, const std::string &filen
             const bool num = std::isdigit(ch);
             while (istr.good() && isNameChar(ch)) {
                 currentToken += ch;
-                ch = readChar(istr,bom);
-                if (num && ch=='\'' && isNameChar(peekChar(istr,bom)))
-                    ch = readChar(istr,bom);
+                if (bom == 0)
+                    istr.appendWhile(currentToken, CC_NAME);
+                ch = istr.readChar(bom);
+                if (num && ch=='\'' && isNameChar(istr.peekChar(bom)))
+                    ch = istr.readChar(bom);
             }
 
-            ungetChar(istr,bom);
+            istr.ungetChar(bom);
         }
 
         // comment
-        else if (ch == '/' && peekChar(istr,bom) == '/') {
+        else if (ch == '/' && istr.peekChar(bom) == '/') {
             while (istr.good() && ch != '\r' && ch != '\n') {
                 currentToken += ch;
-                ch = readChar(istr, bom);
+                if (bom == 0)
+                    istr.appendUntil(currentToken, CC_NEWLINE);
+                ch = istr.readChar(bom);
             }
             const std::string::size_type pos = currentToken.find_last_not_of(" \t");
             if (pos < currentToken.size() - 1U && currentToken[pos] == '\\')
@@ -513,15 +693,17 @@ void simplecpp::TokenList::readfile(std::istream &istr, const std::string &filen
         }
 
         // comment
-        else if (ch == '/' && peekChar(istr,bom) == '*') {
+        else if (ch == '/' && istr.peekChar(bom) == '*') {
             currentToken = "/*";
-            (void)readChar(istr,bom);
-            ch = readChar(istr,bom);
+            (void)istr.readChar(bom);
+            ch = istr.readChar(bom);
             while (istr.good()) {
                 currentToken += ch;
                 if (currentToken.size() >= 4U && endsWith(currentToken, "*/"))
                     break;
-                ch = readChar(istr,bom);
+                if (bom == 0 && ch != '*')
+                    istr.appendUntil(currentToken, CC_NEWLINE | CC_STAR);
+                ch = istr.readChar(bom);
             }
             // multiline..
 
@@ -544,10 +726,10 @@ void simplecpp::TokenList::readfile(std::istream &istr, const std::string &filen
             // C++11 raw string literal
             if (ch == '\"' && cback() && cback()->name && isRawStringId(cback()->str())) {
                 std::string delim;
-                ch = readChar(istr,bom);
+                ch = istr.readChar(bom);
                 while (istr.good() && ch != '(' && ch != '\n') {
                     delim += ch;
-                    ch = readChar(istr,bom);
+                    ch = istr.readChar(bom);
                 }
                 if (!istr.good() || ch == '\n')
                     // TODO report
@@ -555,7 +737,7 @@ void simplecpp::TokenList::readfile(std::istream &istr, const std::string &filen
                 currentToken = '\"';
                 const std::string endOfRawString(')' + delim + '\"');
                 while (istr.good() && !endsWith(currentToken, endOfRawString))
-                    currentToken += readChar(istr,bom);
+                    currentToken += istr.readChar(bom);
                 if (!endsWith(currentToken, endOfRawString))
                     // TODO report
                     return;
@@ -1041,7 +1223,7 @@ void simplecpp::TokenList::removeComments()
     }
 }
 
-std::string simplecpp::TokenList::readUntil(std::istream &istr, const Location &location, const char start, const char end, OutputList *outputList)
+std::string simplecpp::TokenList::readUntil(Stream &istr, const Location &location, const char start, const char end, OutputList *outputList)
 {
     std::string ret;
     ret += start;
@@ -1111,6 +1293,111 @@ unsigned int simplecpp::TokenList::fileIndex(const std::string &filename)
 
 
 namespace simplecpp {
+    class Macro;
+
+#if __cplusplus >= 201103L
+    typedef std::unordered_map<TokenString, Macro> MacroMap;
+#else
+    typedef std::map<TokenString, Macro> MacroMap;
+#endif
+
+    /** Macro usage seen while an expansion is recorded for the ExpansionCache */
+    struct ExpansionRecord {
+        ExpansionRecord() : cacheable(true) {}
+        std::vector<std::pair<const Macro *, Location> > usage;
+        /** false when the expansion depends on the location (__FILE__, __LINE__, __COUNTER__) */
+        bool cacheable;
+    };
+
+    /**
+     * Macros that are being expanded. These are not expanded again. Macros
+     * are identified by their entry in the MacroMap and the nesting is
+     * shallow so a small vector is cheaper to copy and search than a set.
+     */
+    class ExpandedMacros {
+    public:
+        ExpandedMacros() : record(NULL) {}
+        explicit ExpandedMacros(ExpansionRecord *r) : record(r) {}
+
+        bool contains(const Macro *macro) const {
+            return std::find(macros.begin(), macros.end(), macro) != macros.end();
+        }
+
+        void insert(const Macro *macro) {
+            if (!contains(macro))
+                macros.push_back(macro);
+        }
+
+        std::size_t size() const {
+            return macros.size();
+        }
+
+        /** macro is used at loc during this expansion */
+        void used(const Macro *macro, const Location &loc) const {
+            if (record)
+                record->usage.push_back(std::make_pair(macro, loc));
+        }
+
+        /** the expansion depends on more than the macro arguments */
+        void setNotCacheable() const {
+            if (record)
+                record->cacheable = false;
+        }
+
+    private:
+        std::vector<const Macro *> macros;
+        ExpansionRecord *record;
+    };
+
+    /**
+     * Expansions of macros invoked in the code. An object like macro, or a
+     * function like macro invoked with the same argument tokens, expands to
+     * the same tokens until a macro is defined or undefined.
+     */
+    class ExpansionCache {
+    public:
+        /** location in an expansion, either the location of the invocation or a location in a macro definition */
+        struct CachedLocation {
+            CachedLocation(const Location &loc, const Location &invocation) : location(loc), atInvocation(loc.fileIndex == invocation.fileIndex && loc.line == invocation.line && loc.col == invocation.col) {}
+            const Location &get(const Location &invocation) const {
+                return atInvocation ? invocation : location;
+            }
+            Location location;
+            bool atInvocation;
+        };
+
+        struct CachedToken {
+            CachedToken(const Token *tok, const Location &invocation) : str(tok->str()), macro(tok->macro), location(tok->location, invocation) {}
+            TokenString str;
+            TokenString macro;
+            CachedLocation location;
+        };
+
+        struct Entry {
+            std::vector<CachedToken> tokens;
+            std::vector<std::pair<const Macro *, CachedLocation> > usage;
+            bool moreTokens;
+        };
+
+        typedef std::pair<const Macro *, std::vector<TokenString> > Key;
+
+        const Entry *find(const Key &key) const {
+            const std::map<Key, Entry>::const_iterator it = entries.find(key);
+            return it == entries.end() ? NULL : &it->second;
+        }
+
+        Entry &insert(const Key &key) {
+            return entries[key];
+        }
+
+        void clear() {
+            entries.clear();
+        }
+
+    private:
+        std::map<Key, Entry> entries;
+    };
+
     class Macro {
     public:
         explicit Macro(std::vector<std::string> &f) : nameTokDef(NULL), variadic(false), valueToken(NULL), endToken(NULL), files(f), tokenListDefine(f), valueDefinedInCode_(false) {}
@@ -1165,14 +1452,16 @@ namespace simplecpp {
          * @param rawtok     macro token
          * @param macros     list of macros
          * @param inputFiles the input files
+         * @param cache      expansions of earlier invocations
          * @return token after macro
          * @throw Can throw wrongNumberOfParameters or invalidHashHash
          */
         const Token * expand(TokenList * const output,
                              const Token * rawtok,
-                             const std::map<TokenString,Macro> &macros,
-                             std::vector<std::string> &inputFiles) const {
-            std::set<TokenString> expandedmacros;
+                             const MacroMap &macros,
+                             std::vector<std::string> &inputFiles,
+                             ExpansionCache &cache) const {
+            ExpandedMacros expandedmacros;
 
             TokenList output2(inputFiles);
 
@@ -1195,8 +1484,11 @@ namespace simplecpp {
                     rawtokens2.push_back(new Token(rawtok->str(), rawtok1->location));
                     rawtok = rawtok->next;
                 }
-                if (expand(&output2, rawtok1->location, rawtokens2.cfront(), macros, expandedmacros))
+                if (expandCached(&output2, rawtok1->location, rawtokens2.cfront(), macros, cache))
                     rawtok = rawtok1->next;
+            } else if (!functionLike()) {
+                expandCached(&output2, rawtok->location, rawtok, macros, cache);
+                rawtok = rawtok->next;
             } else {
                 rawtok = expand(&output2, rawtok->location, rawtok, macros, expandedmacros);
             }
@@ -1214,14 +1506,14 @@ namespace simplecpp {
                 }
                 if (macro2tok) { // macro2tok->op == '('
                     macro2tok = macro2tok->previous;
-                    expandedmacros.insert(name());
+                    expandedmacros.insert(this);
                 } else if (rawtok->op == '(')
                     macro2tok = output2.back();
                 if (!macro2tok || !macro2tok->name)
                     break;
                 if (output2.cfront() != output2.cback() && macro2tok->str() == this->name())
                     break;
-                const std::map<TokenString,Macro>::const_iterator macro = macros.find(macro2tok->str());
+                const MacroMap::const_iterator macro = macros.find(macro2tok->str());
                 if (macro == macros.end() || !macro->second.functionLike())
                     break;
                 TokenList rawtokens2(inputFiles);
@@ -1254,6 +1546,44 @@ namespace simplecpp {
             return rawtok;
         }
 
+        /**
+         * Expand macro invocation, or replay the expansion of an identical
+         * earlier invocation.
+         * @return true if there are tokens after the invocation
+         */
+        bool expandCached(TokenList * const output, const Location &loc, const Token * const nameTokInst, const MacroMap &macros, ExpansionCache &cache) const {
+            ExpansionCache::Key key(this, std::vector<TokenString>());
+            if (functionLike()) {
+                for (const Token *tok = nameTokInst->next; tok; tok = tok->next)
+                    key.second.push_back(tok->str());
+            }
+
+            const ExpansionCache::Entry *cached = cache.find(key);
+            if (cached) {
+                for (std::vector<ExpansionCache::CachedToken>::const_iterator it = cached->tokens.begin(); it != cached->tokens.end(); ++it) {
+                    Token *tok = new Token(it->str, it->location.get(loc));
+                    tok->macro = it->macro;
+                    output->push_back(tok);
+                }
+                for (std::vector<std::pair<const Macro *, ExpansionCache::CachedLocation> >::const_iterator it = cached->usage.begin(); it != cached->usage.end(); ++it)
+                    it->first->usageList.push_back(it->second.get(loc));
+                return cached->moreTokens;
+            }
+
+            ExpansionRecord record;
+            const Token * const output_end_1 = output->back();
+            const bool moreTokens = expand(output, loc, nameTokInst, macros, ExpandedMacros(&record)) != NULL;
+            if (record.cacheable) {
+                ExpansionCache::Entry &entry = cache.insert(key);
+                for (const Token *tok = output_end_1 ? output_end_1->next : output->cfront(); tok; tok = tok->next)
+                    entry.tokens.push_back(ExpansionCache::CachedToken(tok, loc));
+                for (std::vector<std::pair<const Macro *, Location> >::const_iterator it = record.usage.begin(); it != record.usage.end(); ++it)
+                    entry.usage.push_back(std::make_pair(it->first, ExpansionCache::CachedLocation(it->second, loc)));
+                entry.moreTokens = moreTokens;
+            }
+            return moreTokens;
+        }
+
         /** macro name */
         const TokenString &name() const {
             return nameTokDef->str();
@@ -1383,8 +1713,8 @@ namespace simplecpp {
 
         const Token *appendTokens(TokenList *tokens,
                                   const Token *lpar,
-                                  const std::map<TokenString,Macro> &macros,
-                                  const std::set<TokenString> &expandedmacros,
+                                  const MacroMap &macros,
+                                  const ExpandedMacros &expandedmacros,
                                   const std::vector<const Token*> &parametertokens) const {
             if (!lpar || lpar->op != '(')
                 return NULL;
@@ -1399,8 +1729,8 @@ namespace simplecpp {
                 } else {
                     if (!expandArg(tokens, tok, tok->location, macros, expandedmacros, parametertokens)) {
                         bool expanded = false;
-                        const std::map<TokenString, Macro>::const_iterator it = macros.find(tok->str());
-                        if (it != macros.end() && expandedmacros.find(tok->str()) == expandedmacros.end()) {
+                        const MacroMap::const_iterator it = macros.find(tok->str());
+                        if (it != macros.end() && !expandedmacros.contains(&it->second)) {
                             const Macro &m = it->second;
                             if (!m.functionLike()) {
                                 m.expand(tokens, tok->location, tok, macros, expandedmacros);
@@ -1424,20 +1754,24 @@ namespace simplecpp {
             return sameline(lpar,tok) ? tok : NULL;
         }
 
-        const Token * expand(TokenList * const output, const Location &loc, const Token * const nameTokInst, const std::map<TokenString,Macro> &macros, std::set<TokenString> expandedmacros) const {
-            expandedmacros.insert(nameTokInst->str());
+        const Token * expand(TokenList * const output, const Location &loc, const Token * const nameTokInst, const MacroMap &macros, ExpandedMacros expandedmacros) const {
+            expandedmacros.insert(this);
 
             usageList.push_back(loc);
+            expandedmacros.used(this, loc);
 
             if (nameTokInst->str() == "__FILE__") {
+                expandedmacros.setNotCacheable();
                 output->push_back(new Token('\"'+loc.file()+'\"', loc));
                 return nameTokInst->next;
             }
             if (nameTokInst->str() == "__LINE__") {
+                expandedmacros.setNotCacheable();
                 output->push_back(new Token(toString(loc.line), loc));
                 return nameTokInst->next;
             }
             if (nameTokInst->str() == "__COUNTER__") {
+                expandedmacros.setNotCacheable();
                 output->push_back(new Token(toString(usageList.size()-1U), loc));
                 return nameTokInst->next;
             }
@@ -1477,7 +1811,7 @@ namespace simplecpp {
                     }
                 }
 
-                const std::map<TokenString,Macro>::const_iterator m = macros.find("__COUNTER__");
+                const MacroMap::const_iterator m = macros.find("__COUNTER__");
 
                 if (!counter || m == macros.end())
                     parametertokens2.swap(parametertokens1);
@@ -1488,6 +1822,7 @@ namespace simplecpp {
                         if (tok->str() == "__COUNTER__") {
                             tokensparams.push_back(new Token(toString(counterMacro.usageList.size()), tok->location));
                             counterMacro.usageList.push_back(tok->location);
+                            expandedmacros.setNotCacheable();
                         } else {
                             tokensparams.push_back(new Token(*tok));
                             if (tok == parametertokens1[par]) {
@@ -1555,7 +1890,7 @@ namespace simplecpp {
             return functionLike() ? parametertokens2.back()->next : nameTokInst->next;
         }
 
-        const Token *expandToken(TokenList *output, const Location &loc, const Token *tok, const std::map<TokenString,Macro> &macros, const std::set<TokenString> &expandedmacros, const std::vector<const Token*> &parametertokens) const {
+        const Token *expandToken(TokenList *output, const Location &loc, const Token *tok, const MacroMap &macros, const ExpandedMacros &expandedmacros, const std::vector<const Token*> &parametertokens) const {
             // Not name..
             if (!tok->name) {
                 output->push_back(newMacroToken(tok->str(), loc, true));
@@ -1576,8 +1911,8 @@ namespace simplecpp {
                         return tok->next;
                     }
 
-                    const std::map<TokenString, Macro>::const_iterator it = macros.find(temp.cback()->str());
-                    if (it == macros.end() || expandedmacros.find(temp.cback()->str()) != expandedmacros.end()) {
+                    const MacroMap::const_iterator it = macros.find(temp.cback()->str());
+                    if (it == macros.end() || expandedmacros.contains(&it->second)) {
                         output->takeTokens(temp);
                         return tok->next;
                     }
@@ -1604,8 +1939,8 @@ namespace simplecpp {
             }
 
             // Macro..
-            const std::map<TokenString, Macro>::const_iterator it = macros.find(tok->str());
-            if (it != macros.end() && expandedmacros.find(tok->str()) == expandedmacros.end()) {
+            const MacroMap::const_iterator it = macros.find(tok->str());
+            if (it != macros.end() && !expandedmacros.contains(&it->second)) {
                 const Macro &calledMacro = it->second;
                 if (!calledMacro.functionLike())
                     return calledMacro.expand(output, loc, tok, macros, expandedmacros);
@@ -1665,7 +2000,7 @@ namespace simplecpp {
             return true;
         }
 
-        bool expandArg(TokenList *output, const Token *tok, const Location &loc, const std::map<TokenString, Macro> &macros, const std::set<TokenString> &expandedmacros, const std::vector<const Token*> &parametertokens) const {
+        bool expandArg(TokenList *output, const Token *tok, const Location &loc, const MacroMap &macros, const ExpandedMacros &expandedmacros, const std::vector<const Token*> &parametertokens) const {
             if (!tok->name)
                 return false;
             const unsigned int argnr = getArgNum(tok->str());
@@ -1674,8 +2009,8 @@ namespace simplecpp {
             if (variadic && argnr + 1U >= parametertokens.size()) // empty variadic parameter
                 return true;
             for (const Token *partok = parametertokens[argnr]->next; partok != parametertokens[argnr + 1U];) {
-                const std::map<TokenString, Macro>::const_iterator it = macros.find(partok->str());
-                if (it != macros.end() && (partok->str() == name() || expandedmacros.find(partok->str()) == expandedmacros.end()))
+                const MacroMap::const_iterator it = macros.find(partok->str());
+                if (it != macros.end() && (partok->str() == name() || !expandedmacros.contains(&it->second)))
                     partok = it->second.expand(output, loc, partok, macros, expandedmacros);
                 else {
                     output->push_back(newMacroToken(partok->str(), loc, isReplaced(expandedmacros)));
@@ -1712,7 +2047,7 @@ namespace simplecpp {
          * @param parametertokens  parameters given when expanding this macro
          * @return token after the X
          */
-        const Token *expandHash(TokenList *output, const Location &loc, const Token *tok, const std::map<TokenString, Macro> &macros, const std::set<TokenString> &expandedmacros, const std::vector<const Token*> &parametertokens) const {
+        const Token *expandHash(TokenList *output, const Location &loc, const Token *tok, const MacroMap &macros, const ExpandedMacros &expandedmacros, const std::vector<const Token*> &parametertokens) const {
             TokenList tokenListHash(files);
             tok = expandToken(&tokenListHash, loc, tok->next, macros, expandedmacros, parametertokens);
             std::ostringstream ostr;
@@ -1735,7 +2070,7 @@ namespace simplecpp {
          * @param parametertokens  parameters given when expanding this macro
          * @return token after B
          */
-        const Token *expandHashHash(TokenList *output, const Location &loc, const Token *tok, const std::map<TokenString, Macro> &macros, const std::set<TokenString> &expandedmacros, const std::vector<const Token*> &parametertokens) const {
+        const Token *expandHashHash(TokenList *output, const Location &loc, const Token *tok, const MacroMap &macros, const ExpandedMacros &expandedmacros, const std::vector<const Token*> &parametertokens) const {
             Token *A = output->back();
             if (!A)
                 throw invalidHashHash(tok->location, name());
@@ -1781,8 +2116,8 @@ namespace simplecpp {
                 tokens.push_back(new Token(strAB, tok->location));
                 // for function like macros, push the (...)
                 if (tokensB.empty() && sameline(B,B->next) && B->next->op=='(') {
-                    const std::map<TokenString,Macro>::const_iterator it = macros.find(strAB);
-                    if (it != macros.end() && expandedmacros.find(strAB) == expandedmacros.end() && it->second.functionLike()) {
+                    const MacroMap::const_iterator it = macros.find(strAB);
+                    if (it != macros.end() && !expandedmacros.contains(&it->second) && it->second.functionLike()) {
                         const Token *tok2 = appendTokens(&tokens, B->next, macros, expandedmacros, parametertokens);
                         if (tok2)
                             nextTok = tok2->next;
@@ -1797,13 +2132,8 @@ namespace simplecpp {
             return nextTok;
         }
 
-        static bool isReplaced(const std::set<std::string> &expandedmacros) {
-            // return true if size > 1
-            std::set<std::string>::const_iterator it = expandedmacros.begin();
-            if (it == expandedmacros.end())
-                return false;
-            ++it;
-            return (it != expandedmacros.end());
+        static bool isReplaced(const ExpandedMacros &expandedmacros) {
+            return expandedmacros.size() > 1U;
         }
 
         /** name token in definition */
@@ -2234,14 +2564,14 @@ std::map<std::string, simplecpp::TokenList*> simplecpp::load(const simplecpp::To
     return ret;
 }
 
-static bool preprocessToken(simplecpp::TokenList &output, const simplecpp::Token **tok1, std::map<std::string, simplecpp::Macro> &macros, std::vector<std::string> &files, simplecpp::OutputList *outputList)
+static bool preprocessToken(simplecpp::TokenList &output, const simplecpp::Token **tok1, simplecpp::MacroMap &macros, simplecpp::ExpansionCache &expansionCache, std::vector<std::string> &files, simplecpp::OutputList *outputList)
 {
     const simplecpp::Token *tok = *tok1;
-    const std::map<std::string,simplecpp::Macro>::const_iterator it = macros.find(tok->str());
+    const simplecpp::MacroMap::const_iterator it = macros.find(tok->str());
     if (it != macros.end()) {
         simplecpp::TokenList value(files);
         try {
-            *tok1 = it->second.expand(&value, tok, macros, files);
+            *tok1 = it->second.expand(&value, tok, macros, files, expansionCache);
         } catch (simplecpp::Macro::Error &err) {
             if (outputList) {
                 simplecpp::Output out(files);
@@ -2285,7 +2615,7 @@ void simplecpp::preprocess(simplecpp::TokenList &output, const simplecpp::TokenL
     sizeOfType.insert(std::pair<std::string, std::size_t>("double *", sizeof(double *)));
     sizeOfType.insert(std::pair<std::string, std::size_t>("long double *", sizeof(long double *)));
 
-    std::map<TokenString, Macro> macros;
+    MacroMap macros;
     for (std::list<std::string>::const_iterator it = dui.defines.begin(); it != dui.defines.end(); ++it) {
         const std::string &macrostr = *it;
         const std::string::size_type eq = macrostr.find('=');
@@ -2303,6 +2633,8 @@ void simplecpp::preprocess(simplecpp::TokenList &output, const simplecpp::TokenL
     macros.insert(std::pair<TokenString,Macro>("__LINE__", Macro("__LINE__", "__LINE__", files)));
     macros.insert(std::pair<TokenString,Macro>("__COUNTER__", Macro("__COUNTER__", "__COUNTER__", files)));
 
+    ExpansionCache expansionCache;
+
     // TRUE => code in current #if block should be kept
     // ELSE_IS_TRUE => code in current #if block should be dropped. the code in the #else should be kept.
     // ALWAYS_FALSE => drop all code in #if and #else
@@ -2376,11 +2708,12 @@ void simplecpp::preprocess(simplecpp::TokenList &output, const simplecpp::TokenL
                 try {
                     const Macro &macro = Macro(rawtok->previous, files);
                     if (dui.undefined.find(macro.name()) == dui.undefined.end()) {
-                        std::map<TokenString, Macro>::iterator it = macros.find(macro.name());
+                        MacroMap::iterator it = macros.find(macro.name());
                         if (it == macros.end())
                             macros.insert(std::pair<TokenString, Macro>(macro.name(), macro));
                         else
                             it->second = macro;
+                        expansionCache.clear();
                     }
                 } catch (const std::runtime_error &) {
                     if (outputList) {
@@ -2402,7 +2735,7 @@ void simplecpp::preprocess(simplecpp::TokenList &output, const simplecpp::TokenL
                 TokenList inc2(files);
                 if (!inc1.empty() && inc1.cfront()->name) {
                     const Token *inctok = inc1.cfront();
-                    if (!preprocessToken(inc2, &inctok, macros, files, outputList)) {
+                    if (!preprocessToken(inc2, &inctok, macros, expansionCache, files, outputList)) {
                         output.clear();
                         return;
                     }
@@ -2526,7 +2859,7 @@ void simplecpp::preprocess(simplecpp::TokenList &output, const simplecpp::TokenL
                         }
 
                         const Token *tmp = tok;
-                        if (!preprocessToken(expr, &tmp, macros, files, outputList)) {
+                        if (!preprocessToken(expr, &tmp, macros, expansionCache, files, outputList)) {
                             output.clear();
                             return;
                         }
@@ -2568,8 +2901,10 @@ void simplecpp::preprocess(simplecpp::TokenList &output, const simplecpp::TokenL
                     const Token *tok = rawtok->next;
                     while (sameline(rawtok,tok) && tok->comment)
                         tok = tok->next;
-                    if (sameline(rawtok, tok))
+                    if (sameline(rawtok, tok)) {
                         macros.erase(tok->str());
+                        expansionCache.clear();
+                    }
                 }
             } else if (ifstates.top() == TRUE && rawtok->str() == PRAGMA && rawtok->next && rawtok->next->str() == ONCE && sameline(rawtok,rawtok->next)) {
                 pragmaOnce.insert(rawtok->location.file());
@@ -2598,7 +2933,7 @@ void simplecpp::preprocess(simplecpp::TokenList &output, const simplecpp::TokenL
         const Location loc(rawtok->location);
         TokenList tokens(files);
 
-        if (!preprocessToken(tokens, &rawtok, macros, files, outputList)) {
+        if (!preprocessToken(tokens, &rawtok, macros, expansionCache, files, outputList)) {
             output.clear();
             return;
         }
@@ -2619,7 +2954,7 @@ void simplecpp::preprocess(simplecpp::TokenList &output, const simplecpp::TokenL
     }
 
     if (macroUsage) {
-        for (std::map<TokenString, simplecpp::Macro>::const_iterator macroIt = macros.begin(); macroIt != macros.end(); ++macroIt) {
+        for (simplecpp::MacroMap::const_iterator macroIt = macros.begin(); macroIt != macros.end(); ++macroIt) {
             const Macro &macro = macroIt->second;
             const std::list<Location> &usage = macro.usage();
             for (std::list<Location>::const_iterator usageIt = usage.begin(); usageIt != usage.end(); ++usageIt) {
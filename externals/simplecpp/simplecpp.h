@@ -180,6 +180,9 @@ namespace simplecpp {
     public:
         explicit TokenList(std::vector<std::string> &filenames);
         TokenList(std::istream &istr, std::vector<std::string> &filenames, const std::string &filename=std::string(), OutputList *outputList = 0);
+        /** Tokenize a contiguous buffer. The buffer is only read during construction and is not copied. */
+        TokenList(const unsigned char *data, std::size_t size, std::vector<std::string> &filenames, const std::string &filename=std::string(), OutputList *outputList = 0);
+        TokenList(const char *data, std::size_t size, std::vector<std::string> &filenames, const std::string &filename=std::string(), OutputList *outputList = 0);
         TokenList(const TokenList &other);
         ~TokenList();
         TokenList &operator=(const TokenList &other);
@@ -194,6 +197,7 @@ namespace simplecpp {
         std::string stringify() const;
 
         void readfile(std::istream &istr, const std::string &filename=std::string(), OutputList *outputList = 0);
+        void readfile(const unsigned char *data, std::size_t size, const std::string &filename=std::string(), OutputList *outputList = 0);
         void constFold();
 
         void removeComments();
@@ -246,7 +250,16 @@ namespace simplecpp {
         /** sizeof(T) */
         std::map<std::string, std::size_t> sizeOfType;
 
+        /** Hash of the data that readfile() read, it changes when the file changes */
+        unsigned long long dataHash() const {
+            return datahash;
+        }
+
     private:
+        class Stream;
+
+        void readfile(Stream &stream, const std::string &filename, OutputList *outputList);
+
         void combineOperators();
 
         void constFoldUnaryNotPosNeg(Token *tok);
@@ -258,7 +271,7 @@ namespace simplecpp {
         void constFoldLogicalOp(Token *tok);
         void constFoldQuestionOp(Token **tok1);
 
-        std::string readUntil(std::istream &istr, const Location &location, const char start, const char end, OutputList *outputList);
+        std::string readUntil(Stream &stream, const Location &location, const char start, const char end, OutputList *outputList);
 
         std::string lastLine(int maxsize=100000) const;
 
@@ -267,6 +280,7 @@ namespace simplecpp {
         Token *frontToken;
         Token *backToken;
         std::vector<std::string> &files;
+        unsigned long long datahash;
     };
 
     /** Tracking how macros are used */
@@ -74,6 +74,28 @@ public:
     /** run checks, the token list is simplified */
     virtual void runSimplifiedChecks(const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger) = 0;
 
+    /**
+     * How far the normal token list must be analysed before runChecks()
+     * and getFileInfo() are called. Checks that don't use the symbol
+     * database or the values with the given settings can return less so
+     * the analysis is skipped when no other check needs it. Checks that
+     * only check the simplified token list return ANALYSIS_AST.
+     */
+    virtual Tokenizer::Analysis requiredAnalysis(const Settings *settings) const {
+        (void)settings;
+        return Tokenizer::ANALYSIS_VALUEFLOW;
+    }
+
+    /**
+     * Does runSimplifiedChecks() check anything with the given settings?
+     * The simplified token list is only created when a check or a rule
+     * uses it.
+     */
+    virtual bool hasSimplifiedChecks(const Settings *settings) const {
+        (void)settings;
+        return true;
+    }
+
     /** get error messages */
     virtual void getErrorMessages(ErrorLogger *errorLogger, const Settings *settings) const = 0;
 
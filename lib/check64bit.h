@@ -57,6 +57,10 @@ public:
         check64BitPortability.pointerassignment();
     }
 
+    Tokenizer::Analysis requiredAnalysis(const Settings *settings) const override {
+        return settings->isEnabled(Settings::PORTABILITY) ? Tokenizer::ANALYSIS_SYMBOLDATABASE : Tokenizer::ANALYSIS_AST;
+    }
+
     /** @brief Run checks against the simplified token list */
     void runSimplifiedChecks(const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger) override {
         (void)tokenizer;
@@ -64,6 +68,10 @@ public:
         (void)errorLogger;
     }
 
+    bool hasSimplifiedChecks(const Settings * /*settings*/) const override {
+        return false;
+    }
+
     /** Check for pointer assignment */
     void pointerassignment();
 
@@ -54,6 +54,14 @@ public:
         check.assertWithSideEffects();
     }
 
+    Tokenizer::Analysis requiredAnalysis(const Settings * /*settings*/) const override {
+        return Tokenizer::ANALYSIS_AST;
+    }
+
+    bool hasSimplifiedChecks(const Settings *settings) const override {
+        return settings->isEnabled(Settings::WARNING);
+    }
+
     void assertWithSideEffects();
 
 protected:
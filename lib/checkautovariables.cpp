@@ -137,7 +137,7 @@ static bool isAutoVarArray(const Token *tok)
 
     // ValueFlow
     if (var->isPointer() && !var->isArgument()) {
-        for (std::list<ValueFlow::Value>::const_iterator it = tok->values().begin(); it != tok->values().end(); ++it) {
+        for (std::vector<ValueFlow::Value>::const_iterator it = tok->values().begin(); it != tok->values().end(); ++it) {
             const ValueFlow::Value &val = *it;
             if (val.isTokValue() && isAutoVarArray(val.tokvalue))
                 return true;
@@ -721,7 +721,7 @@ static std::string lifetimeMessage(const Token *tok, const ValueFlow::Value *val
 
 void CheckAutoVariables::errorReturnDanglingLifetime(const Token *tok, const ValueFlow::Value *val)
 {
-    ErrorPath errorPath = val ? val->errorPath : ErrorPath();
+    ErrorPath errorPath = val ? static_cast<const ErrorPath &>(val->errorPath) : ErrorPath();
     std::string msg = "Returning " + lifetimeMessage(tok, val, errorPath);
     errorPath.emplace_back(tok, "");
     reportError(errorPath, Severity::error, "returnDanglingLifetime", msg + " that will be invalid when returning.", CWE562, false);
@@ -729,7 +729,7 @@ void CheckAutoVariables::errorReturnDanglingLifetime(const Token *tok, const Val
 
 void CheckAutoVariables::errorInvalidLifetime(const Token *tok, const ValueFlow::Value* val)
 {
-    ErrorPath errorPath = val ? val->errorPath : ErrorPath();
+    ErrorPath errorPath = val ? static_cast<const ErrorPath &>(val->errorPath) : ErrorPath();
     std::string msg = "Using " + lifetimeMessage(tok, val, errorPath);
     errorPath.emplace_back(tok, "");
     reportError(errorPath, Severity::error, "invalidLifetime", msg + " that is out of scope.", CWE562, false);
@@ -737,7 +737,7 @@ void CheckAutoVariables::errorInvalidLifetime(const Token *tok, const ValueFlow:
 
 void CheckAutoVariables::errorDanglngLifetime(const Token *tok, const ValueFlow::Value *val)
 {
-    ErrorPath errorPath = val ? val->errorPath : ErrorPath();
+    ErrorPath errorPath = val ? static_cast<const ErrorPath &>(val->errorPath) : ErrorPath();
     std::string tokName = tok ? tok->str() : "x";
     std::string msg = "Non-local variable '" + tokName + "' will use " + lifetimeMessage(tok, val, errorPath);
     errorPath.emplace_back(tok, "");
@@ -58,6 +58,10 @@ public:
         checkBoost.checkBoostForeachModification();
     }
 
+    Tokenizer::Analysis requiredAnalysis(const Settings * /*settings*/) const override {
+        return Tokenizer::ANALYSIS_AST;
+    }
+
     /** @brief %Check for container modification while using the BOOST_FOREACH macro */
     void checkBoostForeachModification();
 
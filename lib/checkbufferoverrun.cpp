@@ -36,6 +36,7 @@
 #include <tinyxml2.h>
 #include <algorithm>
 #include <cstdlib>
+#include <set>
 #include <sstream>
 #include <stack>
 #include <utility>
@@ -419,6 +420,52 @@ static bool checkMinSizes(const std::vector<Library::ArgumentChecks::MinSize> &m
     return error;
 }
 
+const std::vector<const Token *> &CheckBufferOverrun::parameterUsage(const Scope *functionScope, unsigned int declarationId)
+{
+    const std::map<unsigned int, std::vector<const Token *> >::const_iterator it = mParameterUsage.find(declarationId);
+    if (it != mParameterUsage.end())
+        return it->second;
+
+    std::vector<const Token *> &usage = mParameterUsage[declarationId];
+    for (const Token* ftok2 = functionScope->bodyStart; ftok2 != functionScope->bodyEnd; ftok2 = ftok2->next()) {
+        if (Token::Match(ftok2, "if|for|switch|while (")) {
+            // bailout if there is buffer usage..
+            if (bailoutIfSwitch(ftok2, declarationId)) {
+                break;
+            }
+
+            // no bailout is needed. skip the if-block
+            else {
+                // goto end of if block..
+                ftok2 = ftok2->linkAt(1)->linkAt(1);
+                if (Token::simpleMatch(ftok2, "} else {"))
+                    ftok2 = ftok2->linkAt(2);
+                if (!ftok2)
+                    break;
+                continue;
+            }
+        }
+
+        if (ftok2->str() == "}")
+            break;
+
+        if (ftok2->varId() == declarationId) {
+            if (Token::Match(ftok2->previous(), "-- %name%") ||
+                Token::Match(ftok2, "%name% --"))
+                break;
+
+            if (Token::Match(ftok2->previous(), ";|{|}|%op% %name% [ %num% ]")) {
+                usage.push_back(ftok2);
+                continue;
+            }
+        }
+
+        if (Token::Match(ftok2, "%name% ("))
+            usage.push_back(ftok2);
+    }
+    return usage;
+}
+
 void CheckBufferOverrun::checkFunctionParameter(const Token &ftok, unsigned int paramIndex, const ArrayInfo &arrayInfo, const std::list<const Token *>& callstack)
 {
     const std::vector<Library::ArgumentChecks::MinSize> * const minsizes = mSettings->library.argminsizes(&ftok, paramIndex);
@@ -461,42 +508,15 @@ void CheckBufferOverrun::checkFunctionParameter(const Token &ftok, unsigned int
                 return;
 
             // Check the parameter usage in the function scope..
-            for (const Token* ftok2 = func->functionScope->bodyStart; ftok2 != func->functionScope->bodyEnd; ftok2 = ftok2->next()) {
-                if (Token::Match(ftok2, "if|for|switch|while (")) {
-                    // bailout if there is buffer usage..
-                    if (bailoutIfSwitch(ftok2, parameter->declarationId())) {
-                        break;
-                    }
-
-                    // no bailout is needed. skip the if-block
-                    else {
-                        // goto end of if block..
-                        ftok2 = ftok2->linkAt(1)->linkAt(1);
-                        if (Token::simpleMatch(ftok2, "} else {"))
-                            ftok2 = ftok2->linkAt(2);
-                        if (!ftok2)
-                            break;
-                        continue;
-                    }
-                }
-
-                if (ftok2->str() == "}")
-                    break;
-
-                if (ftok2->varId() == parameter->declarationId()) {
-                    if (Token::Match(ftok2->previous(), "-- %name%") ||
-                        Token::Match(ftok2, "%name% --"))
-                        break;
-
-                    if (Token::Match(ftok2->previous(), ";|{|}|%op% %name% [ %num% ]")) {
-                        const MathLib::bigint index = MathLib::toLongNumber(ftok2->strAt(2));
-                        if (index >= 0 && arrayInfo.num(0) > 0 && index >= arrayInfo.num(0)) {
-                            std::list<const Token *> callstack2(callstack);
-                            callstack2.push_back(ftok2);
-
-                            const std::vector<MathLib::bigint> indexes(1, index);
-                            arrayIndexOutOfBoundsError(callstack2, arrayInfo, indexes);
-                        }
+            for (const Token *ftok2 : parameterUsage(func->functionScope, parameter->declarationId())) {
+                if (ftok2->varId() == parameter->declarationId() && Token::Match(ftok2->previous(), ";|{|}|%op% %name% [ %num% ]")) {
+                    const MathLib::bigint index = MathLib::toLongNumber(ftok2->strAt(2));
+                    if (index >= 0 && arrayInfo.num(0) > 0 && index >= arrayInfo.num(0)) {
+                        std::list<const Token *> callstack2(callstack);
+                        callstack2.push_back(ftok2);
+
+                        const std::vector<MathLib::bigint> indexes(1, index);
+                        arrayIndexOutOfBoundsError(callstack2, arrayInfo, indexes);
                     }
                 }
 
@@ -895,32 +915,14 @@ void CheckBufferOverrun::valueFlowCheckArrayIndex(const Token * const tok, const
 
 
 
-void CheckBufferOverrun::checkScope(const Token *tok, const ArrayInfo &arrayInfo)
-{
-    bool reassigned = false;
-
-    for (const Token* const end = tok->scope()->bodyEnd; tok != end; tok = tok->next()) {
-        if (reassigned && tok->str() == ";")
-            break;
-
-        if (tok->varId() != arrayInfo.declarationId())
-            continue;
-
-        if (tok->strAt(1) == "=") {
-            reassigned = true;
-        }
-
-        checkScope_inner(tok, arrayInfo);
-    }
-}
-
-void CheckBufferOverrun::checkScope(const Token *tok, std::map<unsigned int, ArrayInfo> arrayInfos)
+void CheckBufferOverrun::checkScope(const Token *tok, const std::map<unsigned int, ArrayInfo> &arrayInfos)
 {
     unsigned int reassigned = 0;
+    std::set<unsigned int> skip;
 
     for (const Token* const end = tok->scope()->bodyEnd; tok != end; tok = tok->next()) {
         if (reassigned && tok->str() == ";") {
-            arrayInfos.erase(reassigned);
+            skip.insert(reassigned);
             reassigned = 0;
         }
 
@@ -928,7 +930,7 @@ void CheckBufferOverrun::checkScope(const Token *tok, std::map<unsigned int, Arr
             continue;
 
         const std::map<unsigned int, ArrayInfo>::const_iterator arrayInfo = arrayInfos.find(tok->varId());
-        if (arrayInfo == arrayInfos.cend())
+        if (arrayInfo == arrayInfos.cend() || skip.find(tok->varId()) != skip.end())
             continue;
 
         if (tok->strAt(1) == "=") {
@@ -1169,7 +1171,7 @@ void CheckBufferOverrun::checkGlobalAndLocalVariable()
             if (!value)
                 continue;
 
-            for (std::list<ValueFlow::Value>::const_iterator it = tok->values().begin(); it != tok->values().end(); ++it) {
+            for (std::vector<ValueFlow::Value>::const_iterator it = tok->values().begin(); it != tok->values().end(); ++it) {
                 if (!it->isTokValue() || !it->tokvalue)
                     continue;
                 const Variable *var = it->tokvalue->variable();
@@ -1334,6 +1336,29 @@ void CheckBufferOverrun::checkStructVariable()
     for (std::size_t i = 0; i < classes; ++i) {
         const Scope * scope = symbolDatabase->classAndStructScopes[i];
 
+        // check all member arrays in each member function in one pass
+        std::map<unsigned int, ArrayInfo> memberArrayInfos;
+        for (const Variable &var : scope->varlist) {
+            if (var.isArray())
+                memberArrayInfos[var.declarationId()] = ArrayInfo(&var, symbolDatabase);
+        }
+        if (!memberArrayInfos.empty()) {
+            for (const Scope * func_scope : symbolDatabase->functionScopes) {
+                // If struct is declared in a function then check
+                // if scope_func matches
+                if (scope->nestedIn->type == Scope::eFunction &&
+                    scope->nestedIn != func_scope) {
+                    continue;
+                }
+
+                // only check non-empty member functions
+                if (func_scope->functionOf == scope && func_scope->bodyStart->next() != func_scope->bodyEnd) {
+                    // start checking after the {
+                    checkScope(func_scope->bodyStart->next(), memberArrayInfos);
+                }
+            }
+        }
+
         for (std::list<Variable>::const_iterator var = scope->varlist.begin(); var != scope->varlist.end(); ++var) {
             if (!var->isArray())
                 continue;
@@ -1349,16 +1374,6 @@ void CheckBufferOverrun::checkStructVariable()
                     continue;
                 }
 
-                // check for member variables
-                if (func_scope->functionOf == scope) {
-                    // only check non-empty function
-                    if (func_scope->bodyStart->next() != func_scope->bodyEnd) {
-                        // start checking after the {
-                        const Token *tok = func_scope->bodyStart->next();
-                        checkScope(tok, arrayInfo);
-                    }
-                }
-
                 // skip inner scopes..
                 /** @todo false negatives: handle inner scopes someday */
                 if (scope->nestedIn->isClassOrStruct())
@@ -34,6 +34,7 @@
 #include <string>
 #include <vector>
 
+class Scope;
 class Settings;
 class SymbolDatabase;
 class Token;
@@ -192,8 +193,7 @@ public:
     };
 
     /** Check for buffer overruns (based on ArrayInfo) */
-    void checkScope(const Token *tok, const ArrayInfo &arrayInfo);
-    void checkScope(const Token *tok, std::map<unsigned int, ArrayInfo> arrayInfos);
+    void checkScope(const Token *tok, const std::map<unsigned int, ArrayInfo> &arrayInfos);
     void checkScope_inner(const Token *tok, const ArrayInfo &arrayInfo);
 
     /** Check for buffer overruns */
@@ -216,6 +216,14 @@ public:
      */
     void checkFunctionCall(const Token *tok, const ArrayInfo &arrayInfo, std::list<const Token *> callstack);
 
+    /**
+     * Get the tokens in a function body where a parameter is indexed with a constant or
+     * where a function is called. The result is computed once per parameter and cached.
+     * \param functionScope the function scope
+     * \param declarationId declaration id of the parameter
+     */
+    const std::vector<const Token *> &parameterUsage(const Scope *functionScope, unsigned int declarationId);
+
     void arrayIndexOutOfBoundsError(const Token *tok, const ArrayInfo &arrayInfo, const std::vector<MathLib::bigint> &index);
     void arrayIndexOutOfBoundsError(const Token *tok, const ArrayInfo &arrayInfo, const std::vector<ValueFlow::Value> &index);
 
@@ -274,6 +282,9 @@ private:
 
     void valueFlowCheckArrayIndex(const Token * const tok, const ArrayInfo &arrayInfo);
 
+    /** Cached results of parameterUsage(), key: declaration id of parameter */
+    std::map<unsigned int, std::vector<const Token *> > mParameterUsage;
+
 public:
     void getErrorMessages(ErrorLogger *errorLogger, const Settings *settings) const override {
         CheckBufferOverrun c(nullptr, settings, errorLogger);
@@ -32,12 +32,16 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <functional>
 #include <limits>
 #include <list>
+#include <map>
 #include <ostream>
 #include <set>
 #include <stack>
+#include <string>
 #include <utility>
+#include <vector>
 
 // CWE ids used
 static const struct CWE CWE398(398U);   // Indicator of Poor Code Quality
@@ -416,21 +420,108 @@ bool CheckCondition::isOverlappingCond(const Token * const cond1, const Token *
 }
 
 
+/** Mix the hash of a child expression into a hash */
+static std::size_t hashCombine(std::size_t seed, std::size_t value)
+{
+    return seed ^ (value + 0x9e3779b9U + (seed << 6) + (seed >> 2));
+}
+
+/**
+ * Hash of an expression such that isSameExpression() (without following
+ * variables) can only be true for expressions with the same hash. The
+ * operands of commutative operators and comparisons are hashed without
+ * order, so 'x==1' and '1==x' or 'a<b' and 'b>a' get the same hash.
+ */
+static std::size_t expressionHash(bool cpp, const Token *tok)
+{
+    if (!tok)
+        return 0;
+    if (cpp && tok->str() == "." && tok->astOperand1() && tok->astOperand1()->str() == "this")
+        return expressionHash(cpp, tok->astOperand2());
+    if (tok->str() == "!" && Token::simpleMatch(tok->astOperand1(), "!"))
+        return expressionHash(cpp, tok->astOperand1()->astOperand1());
+
+    const std::size_t hash1 = expressionHash(cpp, tok->astOperand1());
+    const std::size_t hash2 = expressionHash(cpp, tok->astOperand2());
+    if (Token::Match(tok, "<|>"))
+        return hashCombine(std::hash<std::string>()("<>"), hash1 + hash2);
+    if (Token::Match(tok, "<=|>="))
+        return hashCombine(std::hash<std::string>()("<=>"), hash1 + hash2);
+
+    std::size_t hash = hashCombine(std::hash<std::string>()(tok->str()), tok->varId());
+    if (tok->isBinaryOp() && Token::Match(tok, "%or%|%oror%|+|*|&|&&|^|==|!="))
+        return hashCombine(hash, hash1 + hash2);
+    return hashCombine(hashCombine(hash, hash1), hash2);
+}
+
+/** For 'x&7' and 'x==1', get the operand that isn't a number */
+static const Token *bitwiseOperand(const Token *cond)
+{
+    if (!Token::Match(cond, "&|==") || !cond->astOperand1() || !cond->astOperand2())
+        return nullptr;
+    if (cond->astOperand2()->isNumber())
+        return cond->astOperand1();
+    if (cond->astOperand1()->isNumber())
+        return cond->astOperand2();
+    return nullptr;
+}
+
+namespace {
+    /**
+     * The conditions of an 'if .. else if ..' chain. The conditions are
+     * bucketed by expression hash, so only conditions that can overlap
+     * are compared.
+     */
+    struct ElseIfChain {
+        /** the '(' token of each condition */
+        std::vector<const Token *> conditions;
+        /** positions of the conditions, by expressionHash() */
+        std::map<std::size_t, std::vector<std::size_t>> byExpression;
+        /** positions of the 'x&7' and 'x==1' conditions, by expressionHash() of 'x' */
+        std::map<std::size_t, std::vector<std::size_t>> byBitwiseOperand;
+    };
+}
+
+/** Add the positions in a bucket that come after the given position */
+static void addLaterPositions(const std::map<std::size_t, std::vector<std::size_t>> &buckets, std::size_t hash, std::size_t position, std::vector<std::size_t> &result)
+{
+    const std::map<std::size_t, std::vector<std::size_t>>::const_iterator bucket = buckets.find(hash);
+    if (bucket == buckets.end())
+        return;
+    result.insert(result.end(), std::upper_bound(bucket->second.begin(), bucket->second.end(), position), bucket->second.end());
+}
+
 void CheckCondition::multiCondition()
 {
     if (!mSettings->isEnabled(Settings::STYLE))
         return;
 
     const SymbolDatabase* const symbolDatabase = mTokenizer->getSymbolDatabase();
+    const bool cpp = mTokenizer->isCPP();
 
+    // Collect each 'else if' chain once, starting at its first 'if'
+    std::list<ElseIfChain> chains;
+    std::map<const Token *, std::pair<const ElseIfChain *, std::size_t>> chainOfCondition;
     for (const Scope &scope : symbolDatabase->scopeList) {
-        if (scope.type != Scope::eIf)
+        if (scope.type != Scope::eIf || chainOfCondition.find(scope.classDef->next()) != chainOfCondition.end())
             continue;
 
-        const Token * const cond1 = scope.classDef->next()->astOperand2();
-
+        chains.push_back(ElseIfChain());
+        ElseIfChain &chain = chains.back();
         const Token * tok2 = scope.classDef->next();
         for (;;) {
+            const std::size_t position = chain.conditions.size();
+            chain.conditions.push_back(tok2);
+            chainOfCondition[tok2] = std::make_pair(&chain, position);
+
+            const Token * const cond = tok2->astOperand2();
+            if (cond && !cond->hasKnownIntValue()) {
+                chain.byExpression[expressionHash(cpp, cond)].push_back(position);
+                const Token * const operand = bitwiseOperand(cond);
+                if (operand)
+                    chain.byBitwiseOperand[expressionHash(cpp, operand)].push_back(position);
+            }
+
             tok2 = tok2->link();
             if (!Token::simpleMatch(tok2, ") {"))
                 break;
@@ -438,12 +529,33 @@ void CheckCondition::multiCondition()
             if (!Token::simpleMatch(tok2, "} else { if ("))
                 break;
             tok2 = tok2->tokAt(4);
+        }
+    }
+
+    // Compare each condition with the later conditions in its chain
+    for (const Scope &scope : symbolDatabase->scopeList) {
+        if (scope.type != Scope::eIf)
+            continue;
+
+        const Token * const cond1 = scope.classDef->next()->astOperand2();
+        if (!cond1 || cond1->hasKnownIntValue())
+            continue;
+
+        const std::pair<const ElseIfChain *, std::size_t> &pos = chainOfCondition[scope.classDef->next()];
+        const ElseIfChain &chain = *pos.first;
+        std::vector<std::size_t> candidates;
+        addLaterPositions(chain.byExpression, expressionHash(cpp, cond1), pos.second, candidates);
+        if (cond1->str() == "&") {
+            const Token * const operand = bitwiseOperand(cond1);
+            if (operand)
+                addLaterPositions(chain.byBitwiseOperand, expressionHash(cpp, operand), pos.second, candidates);
+        }
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
 
-            if (cond1 &&
-                tok2->astOperand2() &&
-                !cond1->hasKnownIntValue() &&
-                !tok2->astOperand2()->hasKnownIntValue() &&
-                isOverlappingCond(cond1, tok2->astOperand2(), true))
+        for (const std::size_t candidate : candidates) {
+            const Token * const tok2 = chain.conditions[candidate];
+            if (isOverlappingCond(cond1, tok2->astOperand2(), true))
                 multiConditionError(tok2, cond1->linenr());
         }
     }
@@ -75,6 +75,10 @@ public:
         checkExceptionSafety.unhandledExceptionSpecification();
     }
 
+    Tokenizer::Analysis requiredAnalysis(const Settings * /*settings*/) const override {
+        return Tokenizer::ANALYSIS_AST;
+    }
+
     /** Don't throw exceptions in destructors */
     void destructors();
 
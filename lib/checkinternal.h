@@ -60,6 +60,14 @@ public:
         checkInternal.checkStlUsage();
     }
 
+    Tokenizer::Analysis requiredAnalysis(const Settings * /*settings*/) const override {
+        return Tokenizer::ANALYSIS_AST;
+    }
+
+    bool hasSimplifiedChecks(const Settings *settings) const override {
+        return settings->isEnabled(Settings::INTERNAL);
+    }
+
     /** @brief %Check if a simple pattern is used inside Token::Match or Token::findmatch */
     void checkTokenMatchPatterns();
 
@@ -109,6 +109,10 @@ public:
         checkLeakAutoVar.check();
     }
 
+    Tokenizer::Analysis requiredAnalysis(const Settings * /*settings*/) const override {
+        return Tokenizer::ANALYSIS_AST;
+    }
+
 private:
 
     /** check for leaks in all scopes */
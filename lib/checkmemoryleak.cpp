@@ -186,9 +186,17 @@ CheckMemoryLeak::AllocType CheckMemoryLeak::getAllocationType(const Token *tok2,
     if (callstack && std::find(callstack->begin(), callstack->end(), func) != callstack->end())
         return No;
 
-    std::list<const Function*> cs;
-    if (!callstack)
-        callstack = &cs;
+    // The result of a top-level query does not depend on the callstack,
+    // so it is computed once per function and then reused.
+    if (!callstack) {
+        const std::map<const Function *, AllocType>::const_iterator it = mFunctionReturnType_.find(func);
+        if (it != mFunctionReturnType_.end())
+            return it->second;
+        std::list<const Function*> cs(1, func);
+        const AllocType allocType = functionReturnType(func, &cs);
+        mFunctionReturnType_[func] = allocType;
+        return allocType;
+    }
 
     callstack->push_back(func);
     return functionReturnType(func, callstack);
@@ -38,6 +38,7 @@
 #include "tokenize.h"
 
 #include <list>
+#include <map>
 #include <string>
 
 class Function;
@@ -152,6 +153,10 @@ public:
 
     /** Function allocates pointed-to argument (a la asprintf)? */
     const char *functionArgAlloc(const Function *func, unsigned int targetpar, AllocType &allocType) const;
+
+private:
+    /** Memoized functionReturnType() results for top-level queries */
+    mutable std::map<const Function *, AllocType> mFunctionReturnType_;
 };
 
 /// @}
@@ -189,6 +194,10 @@ public:
         checkMemoryLeak.checkReallocUsage();
     }
 
+    Tokenizer::Analysis requiredAnalysis(const Settings * /*settings*/) const override {
+        return Tokenizer::ANALYSIS_AST;
+    }
+
     /** @brief Unit testing : testing the white list */
     static bool test_white_list(const std::string &funcname, const Settings *settings, bool cpp);
 
@@ -253,6 +262,10 @@ public:
         checkMemoryLeak.check();
     }
 
+    Tokenizer::Analysis requiredAnalysis(const Settings * /*settings*/) const override {
+        return Tokenizer::ANALYSIS_AST;
+    }
+
     void check();
 
 private:
@@ -297,6 +310,10 @@ public:
         checkMemoryLeak.check();
     }
 
+    Tokenizer::Analysis requiredAnalysis(const Settings * /*settings*/) const override {
+        return Tokenizer::ANALYSIS_AST;
+    }
+
     void check();
 
 private:
@@ -336,6 +353,10 @@ public:
         checkMemoryLeak.check();
     }
 
+    Tokenizer::Analysis requiredAnalysis(const Settings * /*settings*/) const override {
+        return Tokenizer::ANALYSIS_AST;
+    }
+
     void check();
 
 private:
@@ -57,9 +57,17 @@ public:
         CheckPostfixOperator checkPostfixOperator(tokenizer, settings, errorLogger);
         checkPostfixOperator.postfixOperator();
     }
+
+    Tokenizer::Analysis requiredAnalysis(const Settings *settings) const override {
+        return settings->isEnabled(Settings::PERFORMANCE) ? Tokenizer::ANALYSIS_SYMBOLDATABASE : Tokenizer::ANALYSIS_AST;
+    }
     void runSimplifiedChecks(const Tokenizer * /*tokenizer*/, const Settings * /*settings*/, ErrorLogger * /*errorLogger*/) override {
     }
 
+    bool hasSimplifiedChecks(const Settings * /*settings*/) const override {
+        return false;
+    }
+
     /** Check postfix operators */
     void postfixOperator();
 
@@ -68,6 +68,10 @@ public:
     void runSimplifiedChecks(const Tokenizer* /*tokenizer*/, const Settings* /*settings*/, ErrorLogger* /*errorLogger*/) override {
     }
 
+    bool hasSimplifiedChecks(const Settings* /*settings*/) const override {
+        return false;
+    }
+
     /** @brief %Check for 'sizeof sizeof ..' */
     void sizeofsizeof();
 
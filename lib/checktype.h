@@ -66,6 +66,10 @@ public:
         (void)errorLogger;
     }
 
+    bool hasSimplifiedChecks(const Settings * /*settings*/) const override {
+        return false;
+    }
+
     /** @brief %Check for bitwise shift with too big right operand */
     void checkTooBigBitwiseShift();
 
@@ -381,50 +381,52 @@ namespace {
     };
 }
 
-void CheckUnusedFunctions::analyseWholeProgram(ErrorLogger * const errorLogger, const std::string &buildDir)
+void CheckUnusedFunctions::analyseWholeProgram(ErrorLogger * const errorLogger, const std::vector<std::string> &buildDirs)
 {
     std::map<std::string, Location> decls;
     std::set<std::string> calls;
 
-    const std::string filesTxt(buildDir + "/files.txt");
-    std::ifstream fin(filesTxt.c_str());
-    std::string filesTxtLine;
-    while (std::getline(fin, filesTxtLine)) {
-        const std::string::size_type firstColon = filesTxtLine.find(':');
-        if (firstColon == std::string::npos)
-            continue;
-        const std::string::size_type secondColon = filesTxtLine.find(':', firstColon+1);
-        if (secondColon == std::string::npos)
-            continue;
-        const std::string xmlfile = buildDir + '/' + filesTxtLine.substr(0,firstColon);
-        const std::string sourcefile = filesTxtLine.substr(secondColon+1);
-
-        tinyxml2::XMLDocument doc;
-        const tinyxml2::XMLError error = doc.LoadFile(xmlfile.c_str());
-        if (error != tinyxml2::XML_SUCCESS)
-            continue;
-
-        const tinyxml2::XMLElement * const rootNode = doc.FirstChildElement();
-        if (rootNode == nullptr)
-            continue;
+    for (const std::string &buildDir : buildDirs) {
+        const std::string filesTxt(buildDir + "/files.txt");
+        std::ifstream fin(filesTxt.c_str());
+        std::string filesTxtLine;
+        while (std::getline(fin, filesTxtLine)) {
+            const std::string::size_type firstColon = filesTxtLine.find(':');
+            if (firstColon == std::string::npos)
+                continue;
+            const std::string::size_type secondColon = filesTxtLine.find(':', firstColon+1);
+            if (secondColon == std::string::npos)
+                continue;
+            const std::string xmlfile = buildDir + '/' + filesTxtLine.substr(0,firstColon);
+            const std::string sourcefile = filesTxtLine.substr(secondColon+1);
 
-        for (const tinyxml2::XMLElement *e = rootNode->FirstChildElement(); e; e = e->NextSiblingElement()) {
-            if (std::strcmp(e->Name(), "FileInfo") != 0)
+            tinyxml2::XMLDocument doc;
+            const tinyxml2::XMLError error = doc.LoadFile(xmlfile.c_str());
+            if (error != tinyxml2::XML_SUCCESS)
                 continue;
-            const char *checkattr = e->Attribute("check");
-            if (checkattr == nullptr || std::strcmp(checkattr,"CheckUnusedFunctions") != 0)
+
+            const tinyxml2::XMLElement * const rootNode = doc.FirstChildElement();
+            if (rootNode == nullptr)
                 continue;
-            for (const tinyxml2::XMLElement *e2 = e->FirstChildElement(); e2; e2 = e2->NextSiblingElement()) {
-                const char* functionName = e2->Attribute("functionName");
-                if (functionName == nullptr)
+
+            for (const tinyxml2::XMLElement *e = rootNode->FirstChildElement(); e; e = e->NextSiblingElement()) {
+                if (std::strcmp(e->Name(), "FileInfo") != 0)
                     continue;
-                if (std::strcmp(e2->Name(),"functioncall") == 0) {
-                    calls.insert(functionName);
+                const char *checkattr = e->Attribute("check");
+                if (checkattr == nullptr || std::strcmp(checkattr,"CheckUnusedFunctions") != 0)
                     continue;
-                } else if (std::strcmp(e2->Name(),"functiondecl") == 0) {
-                    const char* lineNumber = e2->Attribute("lineNumber");
-                    if (lineNumber)
-                        decls[functionName] = Location(sourcefile, std::atoi(lineNumber));
+                for (const tinyxml2::XMLElement *e2 = e->FirstChildElement(); e2; e2 = e2->NextSiblingElement()) {
+                    const char* functionName = e2->Attribute("functionName");
+                    if (functionName == nullptr)
+                        continue;
+                    if (std::strcmp(e2->Name(),"functioncall") == 0) {
+                        calls.insert(functionName);
+                        continue;
+                    } else if (std::strcmp(e2->Name(),"functiondecl") == 0) {
+                        const char* lineNumber = e2->Attribute("lineNumber");
+                        if (lineNumber)
+                            decls[functionName] = Location(sourcefile, std::atoi(lineNumber));
+                    }
                 }
             }
         }
@@ -29,6 +29,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 class ErrorLogger;
 class Function;
@@ -66,6 +67,10 @@ public:
     /** @brief Parse current TU and extract file info */
     Check::FileInfo *getFileInfo(const Tokenizer *tokenizer, const Settings *settings) const override;
 
+    Tokenizer::Analysis requiredAnalysis(const Settings *settings) const override {
+        return settings->isEnabled(Settings::UNUSED_FUNCTION) ? Tokenizer::ANALYSIS_SYMBOLDATABASE : Tokenizer::ANALYSIS_AST;
+    }
+
     /** @brief Analyse all file infos for all TU */
     bool analyseWholeProgram(const CTU::FileInfo *ctu, const std::list<Check::FileInfo*> &fileInfo, const Settings& settings, ErrorLogger &errorLogger) override;
 
@@ -73,8 +78,8 @@ public:
 
     std::string analyzerInfo() const;
 
-    /** @brief Combine and analyze all analyzerInfos for all TUs */
-    static void analyseWholeProgram(ErrorLogger * const errorLogger, const std::string &buildDir);
+    /** @brief Combine and analyze all analyzerInfos for all TUs in the given build dirs */
+    static void analyseWholeProgram(ErrorLogger * const errorLogger, const std::vector<std::string> &buildDirs);
 
 private:
 
@@ -96,6 +101,10 @@ private:
     void runSimplifiedChecks(const Tokenizer* /*tokenizer*/, const Settings* /*settings*/, ErrorLogger* /*errorLogger*/) override {
     }
 
+    bool hasSimplifiedChecks(const Settings* /*settings*/) const override {
+        return false;
+    }
+
     static std::string myName() {
         return "Unused functions";
     }
@@ -61,6 +61,10 @@ public:
         checkUnusedVar.checkFunctionVariableUsage();
     }
 
+    Tokenizer::Analysis requiredAnalysis(const Settings *settings) const override {
+        return settings->isEnabled(Settings::STYLE) ? Tokenizer::ANALYSIS_VALUEFLOW : Tokenizer::ANALYSIS_AST;
+    }
+
     /** @brief Run checks against the simplified token list */
     void runSimplifiedChecks(const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger) override {
         (void)tokenizer;
@@ -68,6 +72,10 @@ public:
         (void)errorLogger;
     }
 
+    bool hasSimplifiedChecks(const Settings * /*settings*/) const override {
+        return false;
+    }
+
     /** @brief %Check for unused function variables */
     void checkFunctionVariableUsage_iterateScopes(const Scope* const scope, Variables& variables);
     void checkFunctionVariableUsage();
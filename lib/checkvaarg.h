@@ -54,6 +54,10 @@ public:
         check.va_list_usage();
     }
 
+    Tokenizer::Analysis requiredAnalysis(const Settings * /*settings*/) const override {
+        return Tokenizer::ANALYSIS_AST;
+    }
+
     void va_start_argument();
     void va_list_usage();
 
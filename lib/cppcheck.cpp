@@ -26,6 +26,7 @@
 #include "platform.h"
 #include "preprocessor.h" // Preprocessor
 #include "suppressions.h"
+#include "symboldatabase.h"
 #include "timer.h"
 #include "token.h"
 #include "tokenize.h" // Tokenizer
@@ -55,17 +56,45 @@ static TimerResults S_timerResults;
 static const CWE CWE398(398U);  // Indicator of Poor Code Quality
 
 CppCheck::CppCheck(ErrorLogger &errorLogger, bool useGlobalSuppressions)
-    : mErrorLogger(errorLogger), mExitCode(0), mSuppressInternalErrorFound(false), mUseGlobalSuppressions(useGlobalSuppressions), mTooManyConfigs(false), mSimplify(true)
+    : mErrorLogger(errorLogger), mExitCode(0), mSuppressInternalErrorFound(false), mUseGlobalSuppressions(useGlobalSuppressions), mTooManyConfigs(false), mSimplify(true), mConfigsCache(new ConfigsCache)
 {
 }
 
 CppCheck::~CppCheck()
+{
+    clearFileInfo();
+    S_timerResults.ShowResults(mSettings.showtime);
+    S_timerResults.ShowMemoryResults(mSettings.showmemory);
+}
+
+void CppCheck::showDataCounts(const Tokenizer &tokenizer, const std::string &filename)
+{
+    DataCounts counts;
+    for (const Token *tok = tokenizer.list.front(); tok; tok = tok->next()) {
+        ++counts.tokens;
+        counts.values += tok->values().size();
+    }
+    const SymbolDatabase *symbolDatabase = tokenizer.getSymbolDatabase();
+    if (symbolDatabase) {
+        counts.scopes = symbolDatabase->scopeList.size();
+        counts.variables = symbolDatabase->variableList().size();
+    }
+
+    std::string location = Path::toNativeSeparators(filename);
+    if (!mCurrentConfig.empty())
+        location += ": " + mCurrentConfig;
+    if (mSettings.showmemory == SHOWTIME_FILE)
+        mErrorLogger.reportOut(location + ": " + counts.toString());
+    else
+        S_timerResults.AddCounts(location, counts);
+}
+
+void CppCheck::clearFileInfo()
 {
     while (!mFileInfo.empty()) {
         delete mFileInfo.back();
         mFileInfo.pop_back();
     }
-    S_timerResults.ShowResults(mSettings.showtime);
 }
 
 const char * CppCheck::version()
@@ -81,19 +110,19 @@ const char * CppCheck::extraVersion()
 unsigned int CppCheck::check(const std::string &path)
 {
     std::ifstream fin(path);
-    return checkFile(Path::simplifyPath(path), emptyString, fin);
+    return checkFile(Path::simplifyPath(path), emptyString, &fin, nullptr);
 }
 
 unsigned int CppCheck::check(const std::string &path, const std::string &content)
 {
-    std::istringstream iss(content);
-    return checkFile(Path::simplifyPath(path), emptyString, iss);
+    return checkFile(Path::simplifyPath(path), emptyString, nullptr, &content);
 }
 
 unsigned int CppCheck::check(const ImportProject::FileSettings &fs)
 {
     CppCheck temp(mErrorLogger, mUseGlobalSuppressions);
     temp.mSettings = mSettings;
+    temp.mConfigsCache = mConfigsCache;
     if (!temp.mSettings.userDefines.empty())
         temp.mSettings.userDefines += ';';
     temp.mSettings.userDefines += fs.cppcheckDefines();
@@ -103,10 +132,10 @@ unsigned int CppCheck::check(const ImportProject::FileSettings &fs)
         temp.mSettings.platform(fs.platformType);
     }
     std::ifstream fin(fs.filename);
-    return temp.checkFile(Path::simplifyPath(fs.filename), fs.cfg, fin);
+    return temp.checkFile(Path::simplifyPath(fs.filename), fs.cfg, &fin, nullptr);
 }
 
-unsigned int CppCheck::checkFile(const std::string& filename, const std::string &cfgname, std::istream& fileStream)
+unsigned int CppCheck::checkFile(const std::string& filename, const std::string &cfgname, std::istream *fileStream, const std::string *fileContent)
 {
     mExitCode = 0;
     mSuppressInternalErrorFound = false;
@@ -154,7 +183,12 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
 
         simplecpp::OutputList outputList;
         std::vector<std::string> files;
-        simplecpp::TokenList tokens1(fileStream, files, filename, &outputList);
+        Timer timerReadfile("Preprocessor::readfile", mSettings.showtime, &S_timerResults, mSettings.showmemory);
+        // Content that is already in memory is tokenized without copying it
+        simplecpp::TokenList tokens1 = fileContent ?
+                                       simplecpp::TokenList(fileContent->data(), fileContent->size(), files, filename, &outputList) :
+                                       simplecpp::TokenList(*fileStream, files, filename, &outputList);
+        timerReadfile.Stop();
 
         // If there is a syntax error, report it and stop
         for (const simplecpp::Output &output : outputList) {
@@ -188,7 +222,9 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
             }
         }
 
+        Timer timerLoadFiles("Preprocessor::loadFiles", mSettings.showtime, &S_timerResults, mSettings.showmemory);
         preprocessor.loadFiles(tokens1, files);
+        timerLoadFiles.Stop();
 
         if (!mSettings.plistOutput.empty()) {
             std::string filename2;
@@ -253,7 +289,7 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
             mSettings.nomsg.dump(toolinfo);
 
             // Calculate checksum so it can be compared with old checksum / future checksums
-            const unsigned int checksum = preprocessor.calculateChecksum(tokens1, toolinfo.str());
+            const unsigned long long checksum = preprocessor.calculateChecksum(tokens1, toolinfo.str());
             std::list<ErrorLogger::ErrorMessage> errors;
             if (!mAnalyzerInformation.analyzeFile(mSettings.buildDir, filename, cfgname, checksum, &errors)) {
                 while (!errors.empty()) {
@@ -272,8 +308,8 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
 
         // Get configurations..
         if (mSettings.userDefines.empty() || mSettings.force) {
-            Timer t("Preprocessor::getConfigs", mSettings.showtime, &S_timerResults);
-            configurations = preprocessor.getConfigs(tokens1);
+            Timer t("Preprocessor::getConfigs", mSettings.showtime, &S_timerResults, mSettings.showmemory);
+            configurations = preprocessor.getConfigs(tokens1, mConfigsCache.get());
         } else {
             configurations.insert(mSettings.userDefines);
         }
@@ -311,6 +347,8 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
             }
         }
 
+        const Tokenizer::Analysis analysis = requiredAnalysis();
+        const bool simplify = mSimplify && hasSimplifiedChecks(mSettings);
         std::set<unsigned long long> checksums;
         unsigned int checkCount = 0;
         bool hasValidConfig = false;
@@ -334,7 +372,7 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
             }
 
             if (mSettings.preprocessOnly) {
-                Timer t("Preprocessor::getcode", mSettings.showtime, &S_timerResults);
+                Timer t("Preprocessor::getcode", mSettings.showtime, &S_timerResults, mSettings.showmemory);
                 std::string codeWithoutCfg = preprocessor.getcode(tokens1, mCurrentConfig, files, true);
                 t.Stop();
 
@@ -354,14 +392,14 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
             }
 
             Tokenizer mTokenizer(&mSettings, this);
-            if (mSettings.showtime != SHOWTIME_NONE)
+            if (mSettings.showtime != SHOWTIME_NONE || mSettings.showmemory != SHOWTIME_NONE)
                 mTokenizer.setTimerResults(&S_timerResults);
 
             try {
                 bool result;
 
                 // Create tokens, skip rest of iteration if failed
-                Timer timer("Tokenizer::createTokens", mSettings.showtime, &S_timerResults);
+                Timer timer("Tokenizer::createTokens", mSettings.showtime, &S_timerResults, mSettings.showmemory);
                 const simplecpp::TokenList &tokensP = preprocessor.preprocess(tokens1, mCurrentConfig, files, true);
                 mTokenizer.createTokens(&tokensP);
                 timer.Stop();
@@ -384,13 +422,22 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
                 // Check raw tokens
                 checkRawTokens(mTokenizer);
 
-                // Simplify tokens into normal form, skip rest of iteration if failed
-                Timer timer2("Tokenizer::simplifyTokens1", mSettings.showtime, &S_timerResults);
-                result = mTokenizer.simplifyTokens1(mCurrentConfig);
+                // Simplify tokens into normal form, skip rest of iteration if failed.
+                // The symbol database and ValueFlow are created later, when they are needed.
+                Timer timer2("Tokenizer::simplifyTokens1", mSettings.showtime, &S_timerResults, mSettings.showmemory);
+                result = mTokenizer.simplifyTokens1(mCurrentConfig, Tokenizer::ANALYSIS_AST);
                 timer2.Stop();
                 if (!result)
                     continue;
 
+                // The dump file and the --debug output show the analysis of
+                // every configuration, also the ones purged below
+                if ((mSettings.dump && fdump.is_open()) || mSettings.debugnormal) {
+                    Timer timer3("Tokenizer::analyse", mSettings.showtime, &S_timerResults, mSettings.showmemory);
+                    mTokenizer.analyse(Tokenizer::ANALYSIS_VALUEFLOW);
+                    timer3.Stop();
+                }
+
                 // dump xml if --dump
                 if (mSettings.dump && fdump.is_open()) {
                     fdump << "<dump cfg=\"" << ErrorLogger::toxml(mCurrentConfig) << "\">" << std::endl;
@@ -410,6 +457,13 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
                     checksums.insert(checksum);
                 }
 
+                Timer timer4("Tokenizer::analyse", mSettings.showtime, &S_timerResults, mSettings.showmemory);
+                mTokenizer.analyse(analysis);
+                timer4.Stop();
+
+                if (mSettings.showmemory != SHOWTIME_NONE)
+                    showDataCounts(mTokenizer, filename);
+
                 // Check normal tokens
                 checkNormalTokens(mTokenizer);
 
@@ -418,9 +472,12 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
                     checkUnusedFunctions.parseTokens(mTokenizer, filename.c_str(), &mSettings);
 
                 // simplify more if required, skip rest of iteration if failed
-                if (mSimplify) {
+                if (!simplify) {
+                    if (mSimplify && mSettings.showtime != SHOWTIME_NONE)
+                        S_timerResults.AddSkipped("Tokenizer::simplifyTokenList2");
+                } else {
                     // if further simplification fails then skip rest of iteration
-                    Timer timer3("Tokenizer::simplifyTokenList2", mSettings.showtime, &S_timerResults);
+                    Timer timer3("Tokenizer::simplifyTokenList2", mSettings.showtime, &S_timerResults, mSettings.showmemory);
                     result = mTokenizer.simplifyTokenList2();
                     timer3.Stop();
                     if (!result)
@@ -548,6 +605,38 @@ void CppCheck::checkRawTokens(const Tokenizer &tokenizer)
     executeRules("raw", tokenizer);
 }
 
+Tokenizer::Analysis CppCheck::requiredAnalysis() const
+{
+    // The debug output and the dump file show the symbol database and the values
+    if (mSettings.dump || mSettings.debugnormal || mSettings.debugwarnings)
+        return Tokenizer::ANALYSIS_VALUEFLOW;
+
+    // The analyzer info of the unused functions is taken from the symbol database
+    Tokenizer::Analysis ret = mSettings.buildDir.empty() ? Tokenizer::ANALYSIS_AST : Tokenizer::ANALYSIS_SYMBOLDATABASE;
+    for (const Check *check : Check::instances())
+        ret = std::max(ret, check->requiredAnalysis(&mSettings));
+    return ret;
+}
+
+bool CppCheck::hasSimplifiedChecks(const Settings &settings, const std::list<Check *> &checks)
+{
+    // The debug output of the simplified token list, and the unknown types
+    // of --debug-warnings, that are reported after simplifyTokenList2()
+    if (settings.debugSimplified || settings.debugwarnings)
+        return true;
+
+    for (const Settings::Rule &rule : settings.rules) {
+        if (rule.tokenlist == "simple")
+            return true;
+    }
+
+    for (const Check *check : checks) {
+        if (check->hasSimplifiedChecks(&settings))
+            return true;
+    }
+    return false;
+}
+
 //---------------------------------------------------------------------------
 // CppCheck - A function that checks a normal token list
 //---------------------------------------------------------------------------
@@ -562,16 +651,19 @@ void CppCheck::checkNormalTokens(const Tokenizer &tokenizer)
         if (tokenizer.isMaxTime())
             return;
 
-        Timer timerRunChecks(check->name() + "::runChecks", mSettings.showtime, &S_timerResults);
+        Timer timerRunChecks(check->name() + "::runChecks", mSettings.showtime, &S_timerResults, mSettings.showmemory);
         check->runChecks(&tokenizer, &mSettings, this);
     }
 
     // Analyse the tokens..
 
-    CTU::FileInfo *fi1 = CTU::getFileInfo(&tokenizer);
-    if (fi1) {
-        mFileInfo.push_back(fi1);
-        mAnalyzerInformation.setFileInfo("ctu", fi1->toString());
+    // The CTU information is based on the values
+    if (tokenizer.analysis() == Tokenizer::ANALYSIS_VALUEFLOW) {
+        CTU::FileInfo *fi1 = CTU::getFileInfo(&tokenizer);
+        if (fi1) {
+            mFileInfo.push_back(fi1);
+            mAnalyzerInformation.setFileInfo("ctu", fi1->toString());
+        }
     }
 
     for (const Check *check : Check::instances()) {
@@ -599,7 +691,10 @@ void CppCheck::checkSimplifiedTokens(const Tokenizer &tokenizer)
         if (tokenizer.isMaxTime())
             return;
 
-        Timer timerSimpleChecks((*it)->name() + "::runSimplifiedChecks", mSettings.showtime, &S_timerResults);
+        if (!(*it)->hasSimplifiedChecks(&mSettings))
+            continue;
+
+        Timer timerSimpleChecks((*it)->name() + "::runSimplifiedChecks", mSettings.showtime, &S_timerResults, mSettings.showmemory);
         (*it)->runSimplifiedChecks(&tokenizer, &mSettings, this);
         timerSimpleChecks.Stop();
     }
@@ -739,8 +834,94 @@ static const char * pcreErrorCodeToString(const int pcreExecRet)
     return "";
 }
 
+
+/** The rule patterns of a CppCheck instance, compiled and studied by pcre */
+class RulePatterns {
+public:
+    struct Compiled {
+        Compiled() : re(nullptr), extra(nullptr) {}
+        pcre *re;
+        pcre_extra *extra;
+        /** pcre_compile or pcre_study error, reported each time the rule is used */
+        std::string errorId;
+        std::string errorMsg;
+    };
+
+    explicit RulePatterns(const std::list<Settings::Rule> &rules) {
+        for (const Settings::Rule &rule : rules) {
+            if (!rule.pattern.empty() && mCompiled.find(rule.pattern) == mCompiled.end())
+                compile(rule.pattern, mCompiled[rule.pattern]);
+        }
+    }
+
+    ~RulePatterns() {
+        for (std::map<std::string, Compiled>::iterator it = mCompiled.begin(); it != mCompiled.end(); ++it) {
+            if (it->second.extra)
+                pcre_free_study(it->second.extra);
+            if (it->second.re)
+                pcre_free(it->second.re);
+        }
+    }
+
+    /** @return the compiled pattern, or nullptr if it was not compiled */
+    const Compiled *find(const std::string &pattern) const {
+        const std::map<std::string, Compiled>::const_iterator it = mCompiled.find(pattern);
+        return (it != mCompiled.end()) ? &it->second : nullptr;
+    }
+
+private:
+    RulePatterns(const RulePatterns &) = delete;
+    RulePatterns &operator=(const RulePatterns &) = delete;
+
+    static void compile(const std::string &pattern, Compiled &compiled);
+
+    std::map<std::string, Compiled> mCompiled;
+};
+
+void RulePatterns::compile(const std::string &pattern, Compiled &compiled)
+{
+    const char *pcreCompileErrorStr = nullptr;
+    int erroffset = 0;
+    compiled.re = pcre_compile(pattern.c_str(),0,&pcreCompileErrorStr,&erroffset,nullptr);
+    if (!compiled.re) {
+        if (pcreCompileErrorStr) {
+            compiled.errorId = "pcre_compile";
+            compiled.errorMsg = "pcre_compile failed: " + std::string(pcreCompileErrorStr);
+        }
+        return;
+    }
+
+    // Optimize the regex, but only if PCRE_CONFIG_JIT is available
+#ifdef PCRE_CONFIG_JIT
+    const char *pcreStudyErrorStr = nullptr;
+    compiled.extra = pcre_study(compiled.re, PCRE_STUDY_JIT_COMPILE, &pcreStudyErrorStr);
+    // pcre_study() returns NULL for both errors and when it can not optimize the regex.
+    // The last argument is how one checks for errors.
+    // It is NULL if everything works, and points to an error string otherwise.
+    if (pcreStudyErrorStr) {
+        compiled.errorId = "pcre_study";
+        compiled.errorMsg = "pcre_study failed: " + std::string(pcreStudyErrorStr);
+        // pcre_compile() worked, but pcre_study() returned an error. Free the resources allocated by pcre_compile().
+        pcre_free(compiled.re);
+        compiled.re = nullptr;
+        compiled.extra = nullptr;
+    }
+#endif
+}
+
+#else
+
+class RulePatterns {
+public:
+    explicit RulePatterns(const std::list<Settings::Rule> & /*rules*/) {}
+};
+
 #endif // HAVE_RULES
 
+void CppCheck::compileRules()
+{
+    mSettings.rulePatterns = std::shared_ptr<const RulePatterns>(new RulePatterns(mSettings.rules));
+}
 
 void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &tokenizer)
 {
@@ -759,28 +940,34 @@ void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &token
     if (isrule == false)
         return;
 
-    // Write all tokens in a string that can be parsed by pcre
-    std::ostringstream ostr;
-    for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next())
-        ostr << " " << tok->str();
-    const std::string str(ostr.str());
+    // Write all tokens in a string that can be parsed by pcre. Remember
+    // where each token ends so the token of a match can be looked up.
+    std::string str;
+    std::vector<std::size_t> tokenEnds;
+    std::vector<const Token *> tokens;
+    for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next()) {
+        str += ' ';
+        str += tok->str();
+        tokenEnds.push_back(str.size());
+        tokens.push_back(tok);
+    }
 
     for (std::list<Settings::Rule>::const_iterator it = mSettings.rules.begin(); it != mSettings.rules.end(); ++it) {
         const Settings::Rule &rule = *it;
         if (rule.pattern.empty() || rule.id.empty() || rule.severity == Severity::none || rule.tokenlist != tokenlist)
             continue;
 
-        const char *pcreCompileErrorStr = nullptr;
-        int erroffset = 0;
-        pcre * const re = pcre_compile(rule.pattern.c_str(),0,&pcreCompileErrorStr,&erroffset,nullptr);
-        if (!re) {
-            if (pcreCompileErrorStr) {
-                const std::string msg = "pcre_compile failed: " + std::string(pcreCompileErrorStr);
+        // Library users that did not call compileRules(), or changed the rules after it
+        if (!mSettings.rulePatterns || !mSettings.rulePatterns->find(rule.pattern))
+            compileRules();
+        const RulePatterns::Compiled &compiled = *mSettings.rulePatterns->find(rule.pattern);
+        if (!compiled.re) {
+            if (!compiled.errorId.empty()) {
                 const ErrorLogger::ErrorMessage errmsg(std::list<ErrorLogger::ErrorMessage::FileLocation>(),
                                                        emptyString,
                                                        Severity::error,
-                                                       msg,
-                                                       "pcre_compile",
+                                                       compiled.errorMsg,
+                                                       compiled.errorId,
                                                        false);
 
                 reportErr(errmsg);
@@ -788,35 +975,10 @@ void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &token
             continue;
         }
 
-        // Optimize the regex, but only if PCRE_CONFIG_JIT is available
-#ifdef PCRE_CONFIG_JIT
-        const char *pcreStudyErrorStr = nullptr;
-        pcre_extra * const pcreExtra = pcre_study(re, PCRE_STUDY_JIT_COMPILE, &pcreStudyErrorStr);
-        // pcre_study() returns NULL for both errors and when it can not optimize the regex.
-        // The last argument is how one checks for errors.
-        // It is NULL if everything works, and points to an error string otherwise.
-        if (pcreStudyErrorStr) {
-            const std::string msg = "pcre_study failed: " + std::string(pcreStudyErrorStr);
-            const ErrorLogger::ErrorMessage errmsg(std::list<ErrorLogger::ErrorMessage::FileLocation>(),
-                                                   emptyString,
-                                                   Severity::error,
-                                                   msg,
-                                                   "pcre_study",
-                                                   false);
-
-            reportErr(errmsg);
-            // pcre_compile() worked, but pcre_study() returned an error. Free the resources allocated by pcre_compile().
-            pcre_free(re);
-            continue;
-        }
-#else
-        const pcre_extra * const pcreExtra = nullptr;
-#endif
-
         int pos = 0;
         int ovector[30]= {0};
         while (pos < (int)str.size()) {
-            const int pcreExecRet = pcre_exec(re, pcreExtra, str.c_str(), (int)str.size(), pos, 0, ovector, 30);
+            const int pcreExecRet = pcre_exec(compiled.re, compiled.extra, str.c_str(), (int)str.size(), pos, 0, ovector, 30);
             if (pcreExecRet < 0) {
                 const std::string errorMessage = pcreErrorCodeToString(pcreExecRet);
                 if (!errorMessage.empty()) {
@@ -842,14 +1004,11 @@ void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &token
             loc.setfile(tokenizer.list.getSourceFilePath());
             loc.line = 0;
 
-            std::size_t len = 0;
-            for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next()) {
-                len = len + 1U + tok->str().size();
-                if (len > pos1) {
-                    loc.setfile(tokenizer.list.getFiles().at(tok->fileIndex()));
-                    loc.line = tok->linenr();
-                    break;
-                }
+            const std::vector<std::size_t>::const_iterator tokenEnd = std::upper_bound(tokenEnds.begin(), tokenEnds.end(), (std::size_t)pos1);
+            if (tokenEnd != tokenEnds.end()) {
+                const Token *tok = tokens[tokenEnd - tokenEnds.begin()];
+                loc.setfile(tokenizer.list.getFiles().at(tok->fileIndex()));
+                loc.line = tok->linenr();
             }
 
             const std::list<ErrorLogger::ErrorMessage::FileLocation> callStack(1, loc);
@@ -865,14 +1024,6 @@ void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &token
             // Report error
             reportErr(errmsg);
         }
-
-        pcre_free(re);
-#ifdef PCRE_CONFIG_JIT
-        // Free up the EXTRA PCRE value (may be NULL at this point)
-        if (pcreExtra) {
-            pcre_free_study(pcreExtra);
-        }
-#endif
     }
 #endif
 }
@@ -961,7 +1112,7 @@ void CppCheck::reportErr(const ErrorLogger::ErrorMessage &msg)
         return;
 
     // Alert only about unique errors
-    if (std::find(mErrorList.begin(), mErrorList.end(), errmsg) != mErrorList.end())
+    if (mErrorList.find(errmsg) != mErrorList.end())
         return;
 
     const Suppressions::ErrorMessage errorMessage = msg.toSuppressionsErrorMessage();
@@ -981,7 +1132,7 @@ void CppCheck::reportErr(const ErrorLogger::ErrorMessage &msg)
     if (!mSettings.nofail.isSuppressed(errorMessage) && (mUseGlobalSuppressions || !mSettings.nomsg.isSuppressed(errorMessage)))
         mExitCode = 1;
 
-    mErrorList.push_back(errmsg);
+    mErrorList.insert(errmsg);
 
     mErrorLogger.reportErr(msg);
     mAnalyzerInformation.reportErr(msg, mSettings.verbose);
@@ -1055,47 +1206,67 @@ void CppCheck::analyseWholeProgram(const std::string &buildDir, const std::map<s
     (void)files;
     if (buildDir.empty())
         return;
+    analyseBuildDirs(std::vector<std::string>(1, buildDir), false);
+}
+
+unsigned int CppCheck::mergeBuildDirs(const std::vector<std::string> &buildDirs)
+{
+    mExitCode = 0;
+    // A header can be checked in several shards, its errors are reported once
+    mErrorList.clear();
+    analyseBuildDirs(buildDirs, true);
+    return mExitCode;
+}
+
+void CppCheck::analyseBuildDirs(const std::vector<std::string> &buildDirs, bool reportStoredErrors)
+{
     if (mSettings.isEnabled(Settings::UNUSED_FUNCTION))
-        CheckUnusedFunctions::analyseWholeProgram(this, buildDir);
+        CheckUnusedFunctions::analyseWholeProgram(this, buildDirs);
     std::list<Check::FileInfo*> fileInfoList;
     CTU::FileInfo ctuFileInfo;
 
     // Load all analyzer info data..
-    const std::string filesTxt(buildDir + "/files.txt");
-    std::ifstream fin(filesTxt);
-    std::string filesTxtLine;
-    while (std::getline(fin, filesTxtLine)) {
-        const std::string::size_type firstColon = filesTxtLine.find(':');
-        if (firstColon == std::string::npos)
-            continue;
-        const std::string::size_type lastColon = filesTxtLine.rfind(':');
-        if (firstColon == lastColon)
-            continue;
-        const std::string xmlfile = buildDir + '/' + filesTxtLine.substr(0,firstColon);
-        //const std::string sourcefile = filesTxtLine.substr(lastColon+1);
-
-        tinyxml2::XMLDocument doc;
-        const tinyxml2::XMLError error = doc.LoadFile(xmlfile.c_str());
-        if (error != tinyxml2::XML_SUCCESS)
-            continue;
-
-        const tinyxml2::XMLElement * const rootNode = doc.FirstChildElement();
-        if (rootNode == nullptr)
-            continue;
-
-        for (const tinyxml2::XMLElement *e = rootNode->FirstChildElement(); e; e = e->NextSiblingElement()) {
-            if (std::strcmp(e->Name(), "FileInfo") != 0)
+    for (const std::string &buildDir : buildDirs) {
+        const std::string filesTxt(buildDir + "/files.txt");
+        std::ifstream fin(filesTxt);
+        std::string filesTxtLine;
+        while (std::getline(fin, filesTxtLine)) {
+            const std::string::size_type firstColon = filesTxtLine.find(':');
+            if (firstColon == std::string::npos)
                 continue;
-            const char *checkClassAttr = e->Attribute("check");
-            if (!checkClassAttr)
+            const std::string::size_type lastColon = filesTxtLine.rfind(':');
+            if (firstColon == lastColon)
                 continue;
-            if (std::strcmp(checkClassAttr, "ctu") == 0) {
-                ctuFileInfo.loadFromXml(e);
+            const std::string xmlfile = buildDir + '/' + filesTxtLine.substr(0,firstColon);
+            //const std::string sourcefile = filesTxtLine.substr(lastColon+1);
+
+            tinyxml2::XMLDocument doc;
+            const tinyxml2::XMLError error = doc.LoadFile(xmlfile.c_str());
+            if (error != tinyxml2::XML_SUCCESS)
                 continue;
-            }
-            for (Check *check : Check::instances()) {
-                if (checkClassAttr == check->name())
-                    fileInfoList.push_back(check->loadFileInfoFromXml(e));
+
+            const tinyxml2::XMLElement * const rootNode = doc.FirstChildElement();
+            if (rootNode == nullptr)
+                continue;
+
+            for (const tinyxml2::XMLElement *e = rootNode->FirstChildElement(); e; e = e->NextSiblingElement()) {
+                if (reportStoredErrors && std::strcmp(e->Name(), "error") == 0) {
+                    reportErr(ErrorLogger::ErrorMessage(e));
+                    continue;
+                }
+                if (std::strcmp(e->Name(), "FileInfo") != 0)
+                    continue;
+                const char *checkClassAttr = e->Attribute("check");
+                if (!checkClassAttr)
+                    continue;
+                if (std::strcmp(checkClassAttr, "ctu") == 0) {
+                    ctuFileInfo.loadFromXml(e);
+                    continue;
+                }
+                for (Check *check : Check::instances()) {
+                    if (checkClassAttr == check->name())
+                        fileInfoList.push_back(check->loadFileInfoFromXml(e));
+                }
             }
         }
     }
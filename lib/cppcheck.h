@@ -32,8 +32,12 @@
 #include <istream>
 #include <list>
 #include <map>
+#include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
+class ConfigsCache;
 class Tokenizer;
 
 /// @addtogroup Core
@@ -139,23 +143,66 @@ public:
     /** analyse whole program use .analyzeinfo files */
     void analyseWholeProgram(const std::string &buildDir, const std::map<std::string, std::size_t> &files);
 
+    /**
+     * Compile the patterns of the --rule options. Call this before the
+     * files are checked. The copies of the settings that are made for each
+     * file and worker share the compiled patterns, so they are compiled once.
+     * Otherwise they are compiled when a rule is first executed.
+     */
+    void compileRules();
+
+    /** Forget the whole program information collected from the checked files */
+    void clearFileInfo();
+
+    /**
+     * Combine the build dirs of sharded runs (--shard). The errors stored
+     * in the build dirs are reported and the whole program analysis is
+     * done once for all of them.
+     * @return 1 if an error was reported, otherwise 0
+     */
+    unsigned int mergeBuildDirs(const std::vector<std::string> &buildDirs);
+
     /** Check if the user wants to check for unused functions
      * and if it's possible at all */
     bool isUnusedFunctionCheckEnabled() const;
 
+    /**
+     * @brief Is the simplified token list used by the enabled checks,
+     * rules or the debug output? If not, it is not created.
+     */
+    static bool hasSimplifiedChecks(const Settings &settings, const std::list<Check *> &checks = Check::instances());
+
 private:
 
+    /**
+     * @brief Load the analyzer info files of the build dirs and run the
+     * whole program analysis
+     * @param buildDirs build dirs to load
+     * @param reportStoredErrors also report the errors stored in the files
+     */
+    void analyseBuildDirs(const std::vector<std::string> &buildDirs, bool reportStoredErrors);
+
+    /** @brief Report the size of the token list and symbol database (--showmemory) */
+    void showDataCounts(const Tokenizer &tokenizer, const std::string &filename);
+
     /** @brief There has been an internal error => Report information message */
     void internalError(const std::string &filename, const std::string &msg);
 
     /**
-     * @brief Check a file using stream
+     * @brief Check a file using stream or buffer
      * @param filename file name
      * @param cfgname  cfg name
-     * @param fileStream stream the file content can be read from
+     * @param fileStream stream the file content can be read from, if fileContent is null
+     * @param fileContent file content, or null
      * @return number of errors found
      */
-    unsigned int checkFile(const std::string& filename, const std::string &cfgname, std::istream& fileStream);
+    unsigned int checkFile(const std::string& filename, const std::string &cfgname, std::istream *fileStream, const std::string *fileContent);
+
+    /**
+     * @brief How far the normal token list must be analysed for the
+     * enabled checks and the debug output
+     */
+    Tokenizer::Analysis requiredAnalysis() const;
 
     /**
      * @brief Check raw tokens
@@ -198,7 +245,7 @@ private:
      */
     virtual void reportOut(const std::string &outmsg) override;
 
-    std::list<std::string> mErrorList;
+    std::set<std::string> mErrorList;
     Settings mSettings;
 
     void reportProgress(const std::string &filename, const char stage[], const std::size_t value) override;
@@ -229,6 +276,12 @@ private:
     std::list<Check::FileInfo*> mFileInfo;
 
     AnalyzerInformation mAnalyzerInformation;
+
+    /**
+     * Configurations of the headers seen so far, reused for other source
+     * files. Shared with the instances that check() makes for project files.
+     */
+    std::shared_ptr<ConfigsCache> mConfigsCache;
 };
 
 /// @}
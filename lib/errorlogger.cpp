@@ -417,6 +417,123 @@ std::string ErrorLogger::ErrorMessage::toXML() const
     return printer.CStr();
 }
 
+// Quote and escape a string for JSON output
+static std::string toJsonString(const std::string &str)
+{
+    std::string result;
+    result.reserve(str.size() + 2U);
+    result += '"';
+    for (const char c : str) {
+        switch (c) {
+        case '"':
+            result += "\\\"";
+            break;
+        case '\\':
+            result += "\\\\";
+            break;
+        case '\n':
+            result += "\\n";
+            break;
+        case '\r':
+            result += "\\r";
+            break;
+        case '\t':
+            result += "\\t";
+            break;
+        default:
+            if ((unsigned char)c < 0x20) {
+                std::ostringstream es;
+                es << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (unsigned int)(unsigned char)c;
+                result += es.str();
+            } else {
+                result += c;
+            }
+            break;
+        }
+    }
+    result += '"';
+    return result;
+}
+
+static const char *sarifLevel(Severity::SeverityType severity)
+{
+    switch (severity) {
+    case Severity::error:
+        return "error";
+    case Severity::warning:
+        return "warning";
+    case Severity::none:
+        return "none";
+    default:
+        return "note";
+    }
+}
+
+static std::string sarifLocation(const ErrorLogger::ErrorMessage::FileLocation &loc, bool withMessage)
+{
+    std::string result = "{";
+    if (withMessage && !loc.getinfo().empty())
+        result += "\"message\":{\"text\":" + toJsonString(loc.getinfo()) + "},";
+    result += "\"physicalLocation\":{\"artifactLocation\":{\"uri\":" + toJsonString(Path::fromNativeSeparators(loc.getfile(false))) + '}';
+    if (loc.line > 0) {
+        result += ",\"region\":{\"startLine\":" + MathLib::toString(loc.line);
+        if (loc.col > 0)
+            result += ",\"startColumn\":" + MathLib::toString(loc.col);
+        result += '}';
+    }
+    return result + "}}";
+}
+
+std::string ErrorLogger::ErrorMessage::toSarif() const
+{
+    std::string result = "{\"ruleId\":" + toJsonString(_id) +
+                         ",\"level\":\"" + sarifLevel(_severity) + '"' +
+                         ",\"message\":{\"text\":" + toJsonString(mShortMessage) + '}';
+    if (!_callStack.empty()) {
+        result += ",\"locations\":[" + sarifLocation(_callStack.back(), false) + ']';
+        if (_callStack.size() > 1U) {
+            result += ",\"relatedLocations\":[";
+            for (std::list<FileLocation>::const_iterator it = _callStack.begin(); it != _callStack.end(); ++it) {
+                if (it != _callStack.begin())
+                    result += ',';
+                result += sarifLocation(*it, true);
+            }
+            result += ']';
+        }
+    }
+    result += ",\"properties\":{\"severity\":\"" + Severity::toString(_severity) + '"';
+    if (_cwe.id)
+        result += ",\"cwe\":" + MathLib::toString(_cwe.id);
+    if (_inconclusive)
+        result += ",\"inconclusive\":true";
+    return result + "}}";
+}
+
+std::string ErrorLogger::ErrorMessage::getSarifHeader()
+{
+    return std::string("{\n"
+                       "  \"$schema\": \"https://raw.githubusercontent.com/oasis-tcs/sarif-spec/master/Schemata/sarif-schema-2.1.0.json\",\n"
+                       "  \"version\": \"2.1.0\",\n"
+                       "  \"runs\": [\n"
+                       "    {\n"
+                       "      \"tool\": {\n"
+                       "        \"driver\": {\n"
+                       "          \"name\": \"Cppcheck\",\n"
+                       "          \"semanticVersion\": \"") + CppCheck::version() + "\",\n"
+           "          \"informationUri\": \"http://cppcheck.net\"\n"
+           "        }\n"
+           "      },\n"
+           "      \"results\": [";
+}
+
+std::string ErrorLogger::ErrorMessage::getSarifFooter()
+{
+    return "      ]\n"
+           "    }\n"
+           "  ]\n"
+           "}";
+}
+
 void ErrorLogger::ErrorMessage::findAndReplace(std::string &source, const std::string &searchFor, const std::string &replaceWith)
 {
     std::string::size_type index = 0;
@@ -257,6 +257,15 @@ public:
         static std::string getXMLHeader();
         static std::string getXMLFooter();
 
+        /**
+         * Format the error message as a SARIF result object on a single line
+         */
+        std::string toSarif() const;
+
+        /** Start of a SARIF log, the results are written after this */
+        static std::string getSarifHeader();
+        static std::string getSarifFooter();
+
         /**
          * Format the error message into a string.
          * @param verbose use verbose message
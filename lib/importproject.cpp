@@ -20,15 +20,19 @@
 
 #include "path.h"
 #include "settings.h"
+#include "simplecpp.h"
 #include "tinyxml2.h"
 #include "token.h"
 #include "tokenize.h"
 #include "tokenlist.h"
 #include "utils.h"
-#include "../externals/picojson.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
 #include <cstring>
 #include <fstream>
+#include <sstream>
 #include <utility>
 
 
@@ -69,6 +73,151 @@ void ImportProject::ignoreOtherPlatforms(cppcheck::Platform::PlatformType platfo
     }
 }
 
+/** Add the identifiers in a string to a set */
+static void addNames(const std::string &s, std::set<std::string> &names)
+{
+    std::string::size_type pos = 0;
+    while ((pos = s.find_first_of("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_", pos)) != std::string::npos) {
+        const std::string::size_type end = s.find_first_not_of("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_0123456789", pos);
+        names.insert(s.substr(pos, end - pos));
+        pos = end;
+    }
+}
+
+static bool sameline(const simplecpp::Token *tok1, const simplecpp::Token *tok2)
+{
+    return tok1 && tok2 && tok1->location.sameline(tok2->location);
+}
+
+/**
+ * Get the names used in a file and in the headers it includes, or false
+ * if that can't be known: the file can't be read, an \#include uses a
+ * macro or macros paste tokens together with '##'. Headers that are not
+ * found are not read when the file is checked either, so their names
+ * don't matter.
+ */
+static bool getUsedNames(const ImportProject::FileSettings &fs, const Settings &settings, std::set<std::string> &names)
+{
+    std::ifstream fin(fs.filename);
+    if (!fin.is_open())
+        return false;
+
+    simplecpp::OutputList outputList;
+    std::vector<std::string> files;
+    const simplecpp::TokenList tokens(fin, files, fs.filename, &outputList);
+    simplecpp::DUI dui;
+    dui.includePaths = fs.includePaths;
+    dui.includes = settings.userIncludes;
+    std::map<std::string, simplecpp::TokenList *> filedata = simplecpp::load(tokens, files, dui, &outputList);
+
+    bool known = true;
+    std::vector<const simplecpp::TokenList *> tokenLists(1, &tokens);
+    for (std::map<std::string, simplecpp::TokenList *>::const_iterator it = filedata.begin(); it != filedata.end(); ++it)
+        tokenLists.push_back(it->second);
+    for (const simplecpp::TokenList *tokenList : tokenLists) {
+        for (const simplecpp::Token *tok = tokenList->cfront(); tok; tok = tok->next) {
+            if (tok->name)
+                names.insert(tok->str());
+            else if (tok->str() == "##")
+                known = false;
+            if (tok->op == '#' && !sameline(tok->previous, tok) && sameline(tok, tok->next) && tok->next->str() == "include") {
+                const simplecpp::Token *header = tok->next->next;
+                if (!sameline(tok, header))
+                    known = false;
+                else if (header->str().size() < 3U || (header->str()[0] != '\"' && header->str()[0] != '<'))
+                    known = false;
+            }
+        }
+    }
+    simplecpp::cleanup(filedata);
+
+    // Library defines and the defines on the command line can use the macros too
+    for (const std::string &def : settings.library.defines)
+        addNames(def, names);
+    addNames(settings.userDefines, names);
+    return known;
+}
+
+/** Remove the defines of macros that are not used, the value of a define that is used can use more macros */
+static std::string usedDefines(const std::string &defines, std::set<std::string> usedNames)
+{
+    std::vector<std::string> defs;
+    std::string::size_type pos = 0;
+    while (pos <= defines.size()) {
+        const std::string::size_type end = std::min(defines.find(';', pos), defines.size());
+        if (end > pos)
+            defs.push_back(defines.substr(pos, end - pos));
+        pos = end + 1;
+    }
+
+    std::vector<bool> used(defs.size(), false);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (std::size_t i = 0; i < defs.size(); ++i) {
+            if (used[i] || usedNames.find(defs[i].substr(0, defs[i].find_first_of("=("))) == usedNames.end())
+                continue;
+            used[i] = true;
+            changed = true;
+            addNames(defs[i], usedNames);
+        }
+    }
+
+    std::string ret;
+    for (std::size_t i = 0; i < defs.size(); ++i) {
+        if (used[i])
+            ret += defs[i] + ';';
+    }
+    return ret;
+}
+
+std::size_t ImportProject::removeEquivalentFileSettings(const Settings &settings)
+{
+    // Group the file settings by the settings that must be the same. When
+    // a file settings has defines, only that configuration is checked, so
+    // having defines or not is part of the group.
+    std::map<std::string, std::vector<std::list<FileSettings>::iterator>> groups;
+    for (std::list<FileSettings>::iterator it = fileSettings.begin(); it != fileSettings.end(); ++it) {
+        std::ostringstream group;
+        group << it->filename << '\n' << it->standard << '\n' << static_cast<int>(it->platformType) << '\n' << it->cppcheckDefines().empty();
+        for (const std::string &i : it->includePaths)
+            group << '\n' << i;
+        groups[group.str()].push_back(it);
+    }
+
+    std::size_t removed = 0;
+    for (std::map<std::string, std::vector<std::list<FileSettings>::iterator>>::const_iterator group = groups.begin(); group != groups.end(); ++group) {
+        if (group->second.size() < 2)
+            continue;
+
+        // Only read the file when the defines or undefs differ
+        bool differ = false;
+        for (const std::list<FileSettings>::iterator &fs : group->second) {
+            if (fs->cppcheckDefines() != group->second[0]->cppcheckDefines() || fs->undefs != group->second[0]->undefs) {
+                differ = true;
+                break;
+            }
+        }
+        std::set<std::string> usedNames;
+        const bool reduce = differ && getUsedNames(*group->second[0], settings, usedNames);
+
+        std::set<std::string> seen;
+        for (const std::list<FileSettings>::iterator &fs : group->second) {
+            std::string key = reduce ? usedDefines(fs->cppcheckDefines(), usedNames) : fs->cppcheckDefines();
+            key += '\n';
+            for (const std::string &undef : fs->undefs) {
+                if (!reduce || usedNames.find(undef) != usedNames.end())
+                    key += undef + ';';
+            }
+            if (seen.insert(key).second)
+                continue;
+            fileSettings.erase(fs);
+            ++removed;
+        }
+    }
+    return removed;
+}
+
 void ImportProject::FileSettings::setDefines(std::string defs)
 {
     while (defs.find(";%(") != std::string::npos) {
@@ -251,20 +400,223 @@ void ImportProject::FileSettings::parseCommand(const std::string &command)
     setDefines(defs);
 }
 
+namespace {
+    /**
+     * Reader for compile_commands.json that reads one entry at a time, so
+     * large compilation databases are never held in memory as a whole.
+     * String members of the entries are read, other values are skipped.
+     */
+    class CompileCommandsReader {
+    public:
+        explicit CompileCommandsReader(std::istream &istr) : mBuf(istr.rdbuf()), mFirst(true) {}
+
+        /** Read the start of the array. @return false if the input is not an array */
+        bool start() {
+            skipWhitespace();
+            return get() == '[';
+        }
+
+        /**
+         * Read the next entry of the array.
+         * @param entry the string members of the entry
+         * @param error set if the input is not valid
+         * @return false at the end of the array or on error
+         */
+        bool next(std::map<std::string, std::string> &entry, bool &error) {
+            entry.clear();
+            error = true;
+            skipWhitespace();
+            if (peek() == ']') {
+                get();
+                error = false;
+                return false;
+            }
+            if (!mFirst && get() != ',')
+                return false;
+            mFirst = false;
+            skipWhitespace();
+            if (get() != '{')
+                return false;
+            skipWhitespace();
+            if (peek() == '}') {
+                get();
+                error = false;
+                return true;
+            }
+            for (;;) {
+                std::string key;
+                skipWhitespace();
+                if (get() != '\"' || !readString(key))
+                    return false;
+                skipWhitespace();
+                if (get() != ':')
+                    return false;
+                skipWhitespace();
+                if (peek() == '\"') {
+                    get();
+                    if (!readString(entry[key]))
+                        return false;
+                } else if (!skipValue()) {
+                    return false;
+                }
+                skipWhitespace();
+                const int c = get();
+                if (c == '}')
+                    break;
+                if (c != ',')
+                    return false;
+            }
+            error = false;
+            return true;
+        }
+
+    private:
+        int peek() {
+            return mBuf->sgetc();
+        }
+
+        int get() {
+            return mBuf->sbumpc();
+        }
+
+        void skipWhitespace() {
+            int c;
+            while ((c = peek()) == ' ' || c == '\t' || c == '\r' || c == '\n')
+                get();
+        }
+
+        static void appendUtf8(std::string &s, unsigned long code) {
+            if (code < 0x80) {
+                s += static_cast<char>(code);
+            } else if (code < 0x800) {
+                s += static_cast<char>(0xC0 | (code >> 6));
+                s += static_cast<char>(0x80 | (code & 0x3F));
+            } else if (code < 0x10000) {
+                s += static_cast<char>(0xE0 | (code >> 12));
+                s += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                s += static_cast<char>(0x80 | (code & 0x3F));
+            } else {
+                s += static_cast<char>(0xF0 | (code >> 18));
+                s += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                s += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                s += static_cast<char>(0x80 | (code & 0x3F));
+            }
+        }
+
+        bool readHex4(unsigned long &code) {
+            code = 0;
+            for (int i = 0; i < 4; ++i) {
+                const int c = get();
+                if (!std::isxdigit(c))
+                    return false;
+                code = code * 16 + static_cast<unsigned long>(std::isdigit(c) ? (c - '0') : (std::tolower(c) - 'a' + 10));
+            }
+            return true;
+        }
+
+        /** Read a string, after its starting '"' */
+        bool readString(std::string &s) {
+            for (;;) {
+                int c = get();
+                if (c == EOF)
+                    return false;
+                if (c == '\"')
+                    return true;
+                if (c != '\\') {
+                    s += static_cast<char>(c);
+                    continue;
+                }
+                c = get();
+                switch (c) {
+                case '\"':
+                case '\\':
+                case '/':
+                    s += static_cast<char>(c);
+                    break;
+                case 'b':
+                    s += '\b';
+                    break;
+                case 'f':
+                    s += '\f';
+                    break;
+                case 'n':
+                    s += '\n';
+                    break;
+                case 'r':
+                    s += '\r';
+                    break;
+                case 't':
+                    s += '\t';
+                    break;
+                case 'u': {
+                    unsigned long code;
+                    if (!readHex4(code))
+                        return false;
+                    // surrogate pair
+                    if (code >= 0xD800 && code < 0xDC00) {
+                        unsigned long low;
+                        if (get() != '\\' || get() != 'u' || !readHex4(low) || low < 0xDC00 || low >= 0xE000)
+                            return false;
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(s, code);
+                    break;
+                }
+                default:
+                    return false;
+                }
+            }
+        }
+
+        /** Skip a number, literal, array or object */
+        bool skipValue() {
+            int depth = 0;
+            for (;;) {
+                const int c = peek();
+                if (c == EOF)
+                    return false;
+                if (depth == 0 && (c == ',' || c == '}' || c == ']'))
+                    return true;
+                get();
+                if (c == '[' || c == '{') {
+                    ++depth;
+                } else if (c == ']' || c == '}') {
+                    --depth;
+                } else if (c == '\"') {
+                    std::string ignored;
+                    if (!readString(ignored))
+                        return false;
+                }
+            }
+        }
+
+        std::streambuf * const mBuf;
+        bool mFirst;
+    };
+}
+
 void ImportProject::importCompileCommands(std::istream &istr)
 {
-    picojson::value v;
-    istr >> v;
-    if (!v.is<picojson::array>())
+    CompileCommandsReader reader(istr);
+    if (!reader.start())
         return;
 
-    for (const picojson::value &fileInfo : v.get<picojson::array>()) {
-        picojson::object obj = fileInfo.get<picojson::object>();
-        const std::string directory = Path::fromNativeSeparators(obj["directory"].get<std::string>());
-        const std::string command = obj["command"].get<std::string>();
-        const std::string file = Path::fromNativeSeparators(obj["file"].get<std::string>());
+    // Most entries in a compilation database share their include paths, so
+    // each distinct list is only simplified once
+    std::map<std::string, std::list<std::string>> simplifiedIncludePaths;
+
+    // The entries are added when the whole file is valid
+    std::list<FileSettings> entries;
+    std::map<std::string, std::string> entry;
+    bool error = false;
+    while (reader.next(entry, error)) {
+        const std::string directory = Path::fromNativeSeparators(entry["directory"]);
+        const std::string file = Path::fromNativeSeparators(entry["file"]);
+        if (file.empty())
+            continue;
 
-        struct FileSettings fs;
+        entries.push_back(FileSettings());
+        FileSettings &fs = entries.back();
         if (Path::isAbsolute(file) || Path::fileExists(file))
             fs.filename = file;
         else {
@@ -274,11 +626,22 @@ void ImportProject::importCompileCommands(std::istream &istr)
             path += file;
             fs.filename = Path::simplifyPath(path);
         }
-        fs.parseCommand(command); // read settings; -D, -I, -U, -std
-        std::map<std::string, std::string, cppcheck::stricmp> variables;
-        fs.setIncludePaths(directory, fs.includePaths, variables);
-        fileSettings.push_back(fs);
+        fs.parseCommand(entry["command"]); // read settings; -D, -I, -U, -std
+
+        std::string key = directory;
+        for (const std::string &i : fs.includePaths)
+            key += '\n' + i;
+        const std::map<std::string, std::list<std::string>>::const_iterator simplified = simplifiedIncludePaths.find(key);
+        if (simplified != simplifiedIncludePaths.end()) {
+            fs.includePaths = simplified->second;
+        } else {
+            std::map<std::string, std::string, cppcheck::stricmp> variables;
+            fs.setIncludePaths(directory, fs.includePaths, variables);
+            simplifiedIncludePaths[key] = fs.includePaths;
+        }
     }
+    if (!error)
+        fileSettings.splice(fileSettings.end(), entries);
 }
 
 void ImportProject::importSln(std::istream &istr, const std::string &path)
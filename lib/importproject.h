@@ -25,12 +25,15 @@
 #include "platform.h"
 #include "utils.h"
 
+#include <cstddef>
 #include <list>
 #include <map>
 #include <set>
 #include <string>
 #include <vector>
 
+class Settings;
+
 /// @addtogroup Core
 /// @{
 
@@ -83,6 +86,17 @@ public:
     void ignoreOtherConfigs(const std::string &cfg);
     void ignoreOtherPlatforms(cppcheck::Platform::PlatformType platformType);
 
+    /**
+     * Remove file settings that give the same preprocessor input as an
+     * earlier file settings for the same file. Defines and undefs of macros
+     * that the file and its headers never mention make no difference, so
+     * for example a Debug and a Release configuration that only differ in
+     * NDEBUG are checked once if the file doesn't use NDEBUG.
+     * @param settings the settings, for the --include files and the library defines
+     * @return the number of removed file settings
+     */
+    std::size_t removeEquivalentFileSettings(const Settings &settings);
+
     Type import(const std::string &filename);
 protected:
     void importCompileCommands(std::istream &istr);
@@ -481,8 +481,40 @@ std::string MathLib::normalizeCharacterLiteral(const std::string& iLiteral)
     return normalizedLiteral;
 }
 
+// Parse a plain decimal integer literal such as "123", "-4" or "10UL" without
+// going through a stream. Returns false for anything else (hex, octal, binary,
+// floats, digit separators, character literals) and for values that might not
+// fit; those are handled by the generic code in toLongNumber.
+static bool parseDecimalLiteral(const std::string &str, MathLib::bigint &ret)
+{
+    std::string::size_type pos = (!str.empty() && str[0] == '-') ? 1U : 0U;
+    const std::string::size_type start = pos;
+    MathLib::bigint value = 0;
+    while (pos < str.size() && str[pos] >= '0' && str[pos] <= '9') {
+        // 18 digits always fit, longer literals are parsed by the slow path
+        if (pos - start == 18U)
+            return false;
+        value = value * 10 + (str[pos] - '0');
+        ++pos;
+    }
+    const std::string::size_type digits = pos - start;
+    if (digits == 0U || (digits > 1U && str[start] == '0'))
+        return false;
+    for (; pos < str.size(); ++pos) {
+        if (str[pos] != 'u' && str[pos] != 'U' && str[pos] != 'l' && str[pos] != 'L')
+            return false;
+    }
+    ret = (start == 1U) ? -value : value;
+    return true;
+}
+
 MathLib::bigint MathLib::toLongNumber(const std::string & str)
 {
+    // plain decimal numbers, the common case:
+    bigint decimal;
+    if (parseDecimalLiteral(str, decimal))
+        return decimal;
+
     // hexadecimal numbers:
     if (isIntHex(str)) {
         if (str[0] == '-') {
@@ -622,6 +654,26 @@ double MathLib::toDoubleNumber(const std::string &str)
     return ret;
 }
 
+template<> std::string MathLib::toString(MathLib::bigint value)
+{
+    return std::to_string(value);
+}
+
+template<> std::string MathLib::toString(MathLib::biguint value)
+{
+    return std::to_string(value);
+}
+
+template<> std::string MathLib::toString(int value)
+{
+    return std::to_string(value);
+}
+
+template<> std::string MathLib::toString(unsigned int value)
+{
+    return std::to_string(value);
+}
+
 template<> std::string MathLib::toString(double value)
 {
     std::ostringstream result;
@@ -157,7 +157,11 @@ MathLib::value operator^(const MathLib::value &v1, const MathLib::value &v2);
 MathLib::value operator<<(const MathLib::value &v1, const MathLib::value &v2);
 MathLib::value operator>>(const MathLib::value &v1, const MathLib::value &v2);
 
-template<> CPPCHECKLIB std::string MathLib::toString(double value); // Declare specialization to avoid linker problems
+template<> CPPCHECKLIB std::string MathLib::toString(MathLib::bigint value); // Declare specializations to avoid linker problems
+template<> CPPCHECKLIB std::string MathLib::toString(MathLib::biguint value);
+template<> CPPCHECKLIB std::string MathLib::toString(int value);
+template<> CPPCHECKLIB std::string MathLib::toString(unsigned int value);
+template<> CPPCHECKLIB std::string MathLib::toString(double value);
 
 /// @}
 //---------------------------------------------------------------------------
@@ -25,59 +25,102 @@
 #include <cctype>
 #include <cstddef>
 
-PathMatch::PathMatch(const std::vector<std::string> &excludedPaths, bool caseSensitive)
-    : mExcludedPaths(excludedPaths), mCaseSensitive(caseSensitive)
+/** Split the directory part of a path into its components, "a/b/c.cpp" gives "a" and "b" */
+static std::vector<std::string> directoryComponents(const std::string &path)
 {
-    if (!mCaseSensitive)
-        for (std::vector<std::string>::iterator i = mExcludedPaths.begin(); i != mExcludedPaths.end(); ++i)
-            std::transform(i->begin(), i->end(), i->begin(), ::tolower);
-    mWorkingDirectory.push_back(Path::getCurrentPath());
+    std::vector<std::string> components;
+    std::string::size_type start = 0;
+    std::string::size_type slash;
+    while ((slash = path.find('/', start)) != std::string::npos) {
+        components.push_back(path.substr(start, slash - start));
+        start = slash + 1;
+    }
+    return components;
 }
 
-bool PathMatch::match(const std::string &path) const
+PathMatch::Masks::Masks()
+    : mDirectories(1)
 {
-    if (path.empty())
-        return false;
+}
 
-    for (std::vector<std::string>::const_iterator i = mExcludedPaths.begin(); i != mExcludedPaths.end(); ++i) {
-        const std::string excludedPath((!Path::isAbsolute(path) && Path::isAbsolute(*i)) ? Path::getRelativePath(*i, mWorkingDirectory) : *i);
+void PathMatch::Masks::add(const std::string &mask)
+{
+    if (!endsWith(mask, '/')) {
+        mFiles[mask.size()].insert(mask);
+        return;
+    }
 
-        std::string findpath = Path::fromNativeSeparators(path);
-        if (!mCaseSensitive)
-            std::transform(findpath.begin(), findpath.end(), findpath.begin(), ::tolower);
+    std::size_t node = 0;
+    for (const std::string &component : directoryComponents(mask)) {
+        const std::map<std::string, std::size_t>::const_iterator child = mDirectories[node].children.find(component);
+        if (child != mDirectories[node].children.end()) {
+            node = child->second;
+        } else {
+            mDirectories.push_back(DirectoryNode());
+            mDirectories[node].children[component] = mDirectories.size() - 1U;
+            node = mDirectories.size() - 1U;
+        }
+    }
+    mDirectories[node].terminal = true;
+}
 
-        // Filtering directory name
-        if (endsWith(excludedPath,'/')) {
-            if (!endsWith(findpath,'/'))
-                findpath = removeFilename(findpath);
+bool PathMatch::Masks::match(const std::string &path) const
+{
+    // Filtering filename
+    // Check if path ends with mask
+    // -ifoo.cpp matches (./)foo.c, src/foo.cpp and proj/src/foo.cpp
+    // -isrc/file.cpp matches src/foo.cpp and proj/src/foo.cpp
+    for (std::map<std::string::size_type, std::set<std::string>>::const_iterator it = mFiles.begin(); it != mFiles.end() && it->first <= path.size(); ++it) {
+        if (it->second.find(path.substr(path.size() - it->first)) != it->second.end())
+            return true;
+    }
 
-            if (excludedPath.length() > findpath.length())
-                continue;
-            // Match relative paths starting with mask
-            // -isrc matches src/foo.cpp
-            if (findpath.compare(0, excludedPath.size(), excludedPath) == 0)
-                return true;
-            // Match only full directory name in middle or end of the path
-            // -isrc matches myproject/src/ but does not match
-            // myproject/srcfiles/ or myproject/mysrc/
-            if (findpath.find("/" + excludedPath) != std::string::npos)
-                return true;
-        }
-        // Filtering filename
-        else {
-            if (excludedPath.length() > findpath.length())
-                continue;
-            // Check if path ends with mask
-            // -ifoo.cpp matches (./)foo.c, src/foo.cpp and proj/src/foo.cpp
-            // -isrc/file.cpp matches src/foo.cpp and proj/src/foo.cpp
-            if (findpath.compare(findpath.size() - excludedPath.size(), findpath.size(), excludedPath) == 0)
+    // Filtering directory name
+    // Match the mask at the start of the path or at any directory in it
+    // -isrc matches src/foo.cpp and myproject/src/ but does not match
+    // myproject/srcfiles/ or myproject/mysrc/
+    if (mDirectories[0].children.empty())
+        return false;
+    const std::vector<std::string> components = directoryComponents(path);
+    for (std::size_t start = 0; start < components.size(); ++start) {
+        std::size_t node = 0;
+        for (std::size_t i = start; i < components.size(); ++i) {
+            const std::map<std::string, std::size_t>::const_iterator child = mDirectories[node].children.find(components[i]);
+            if (child == mDirectories[node].children.end())
+                break;
+            node = child->second;
+            if (mDirectories[node].terminal)
                 return true;
-
         }
     }
     return false;
 }
 
+PathMatch::PathMatch(const std::vector<std::string> &excludedPaths, bool caseSensitive)
+    : mCaseSensitive(caseSensitive)
+{
+    const std::vector<std::string> workingDirectory(1, Path::getCurrentPath());
+    for (std::string excludedPath : excludedPaths) {
+        if (!mCaseSensitive)
+            std::transform(excludedPath.begin(), excludedPath.end(), excludedPath.begin(), ::tolower);
+        mAbsoluteMasks.add(excludedPath);
+        // Absolute masks are made relative to the working directory when relative paths are matched
+        mRelativeMasks.add(Path::isAbsolute(excludedPath) ? Path::getRelativePath(excludedPath, workingDirectory) : excludedPath);
+    }
+}
+
+bool PathMatch::match(const std::string &path) const
+{
+    if (path.empty())
+        return false;
+
+    std::string findpath = Path::fromNativeSeparators(path);
+    if (!mCaseSensitive)
+        std::transform(findpath.begin(), findpath.end(), findpath.begin(), ::tolower);
+
+    return Path::isAbsolute(path) ? mAbsoluteMasks.match(findpath) : mRelativeMasks.match(findpath);
+}
+
 std::string PathMatch::removeFilename(const std::string &path)
 {
     const std::size_t ind = path.find_last_of('/');
@@ -21,6 +21,9 @@
 
 #include "config.h"
 
+#include <cstddef>
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -29,6 +32,10 @@
 
 /**
  * @brief Simple path matching for ignoring paths in CLI.
+ *
+ * The masks are compiled when the PathMatch is created, so the cost of
+ * match() depends on the length of the path and not on the number of
+ * masks.
  */
 class CPPCHECKLIB PathMatch {
 public:
@@ -58,9 +65,35 @@ protected:
     static std::string removeFilename(const std::string &path);
 
 private:
-    std::vector<std::string> mExcludedPaths;
+    /** Compiled masks, for matching either absolute or relative paths */
+    class Masks {
+    public:
+        Masks();
+
+        /** Add a mask, in the same case as the paths that are matched */
+        void add(const std::string &mask);
+
+        /** Match a path with '/' separators */
+        bool match(const std::string &path) const;
+
+    private:
+        /** Node in the trie of the directory masks, one level per path component */
+        struct DirectoryNode {
+            DirectoryNode() : terminal(false) {}
+            std::map<std::string, std::size_t> children;
+            bool terminal;
+        };
+
+        /** Trie of the directory masks, the root is the first node */
+        std::vector<DirectoryNode> mDirectories;
+
+        /** File masks, by length */
+        std::map<std::string::size_type, std::set<std::string>> mFiles;
+    };
+
+    Masks mAbsoluteMasks;
+    Masks mRelativeMasks;
     bool mCaseSensitive;
-    std::vector<std::string> mWorkingDirectory;
 };
 
 /// @}
@@ -25,6 +25,7 @@
 #include "settings.h"
 #include "simplecpp.h"
 #include "suppressions.h"
+#include "utils.h"
 
 #include <algorithm>
 #include <cstdint>
@@ -320,7 +321,21 @@ static const simplecpp::Token *gotoEndIf(const simplecpp::Token *cmdtok)
     return nullptr;
 }
 
-static void getConfigs(const simplecpp::TokenList &tokens, std::set<std::string> &defined, const std::string &userDefines, const std::set<std::string> &undefined, std::set<std::string> &ret)
+static void insertConfig(std::set<std::string> &ret, const std::string &cfg, ConfigsCache::HeaderConfigs *record)
+{
+    ret.insert(cfg);
+    if (record)
+        record->changes.emplace_back(true, cfg);
+}
+
+static void eraseConfig(std::set<std::string> &ret, const std::string &cfg, ConfigsCache::HeaderConfigs *record)
+{
+    ret.erase(cfg);
+    if (record)
+        record->changes.emplace_back(false, cfg);
+}
+
+static void getConfigs(const simplecpp::TokenList &tokens, std::set<std::string> &defined, const std::string &userDefines, const std::set<std::string> &undefined, std::set<std::string> &ret, ConfigsCache::HeaderConfigs *record)
 {
     std::vector<std::string> configs_if;
     std::vector<std::string> configs_ifndef;
@@ -350,7 +365,7 @@ static void getConfigs(const simplecpp::TokenList &tokens, std::set<std::string>
 
             configs_if.push_back((cmdtok->str() == "ifndef") ? std::string() : config);
             configs_ifndef.push_back((cmdtok->str() == "ifndef") ? config : std::string());
-            ret.insert(cfg(configs_if,userDefines));
+            insertConfig(ret, cfg(configs_if,userDefines), record);
         } else if (cmdtok->str() == "elif" || cmdtok->str() == "else") {
             if (getConfigsElseIsFalse(configs_if,userDefines)) {
                 tok = gotoEndIf(tok);
@@ -379,10 +394,10 @@ static void getConfigs(const simplecpp::TokenList &tokens, std::set<std::string>
                 if (isUndefined(config,undefined))
                     config.clear();
                 configs_if.push_back(config);
-                ret.insert(cfg(configs_if, userDefines));
+                insertConfig(ret, cfg(configs_if, userDefines), record);
             } else if (!configs_ifndef.empty()) {
                 configs_if.push_back(configs_ifndef.back());
-                ret.insert(cfg(configs_if, userDefines));
+                insertConfig(ret, cfg(configs_if, userDefines), record);
             }
         } else if (cmdtok->str() == "endif" && !sameline(tok, cmdtok->next)) {
             if (!configs_if.empty())
@@ -392,10 +407,10 @@ static void getConfigs(const simplecpp::TokenList &tokens, std::set<std::string>
         } else if (cmdtok->str() == "error") {
             if (!configs_ifndef.empty() && !configs_ifndef.back().empty()) {
                 if (configs_ifndef.size() == 1U)
-                    ret.erase("");
+                    eraseConfig(ret, "", record);
                 std::vector<std::string> configs(configs_if);
                 configs.push_back(configs_ifndef.back());
-                ret.erase(cfg(configs, userDefines));
+                eraseConfig(ret, cfg(configs, userDefines), record);
                 if (!elseError.empty())
                     elseError += ';';
                 elseError += cfg(configs_ifndef, userDefines);
@@ -404,10 +419,10 @@ static void getConfigs(const simplecpp::TokenList &tokens, std::set<std::string>
                 const std::string &last = configs_if.back();
                 if (last.size() > 2U && last.compare(last.size()-2U,2,"=0") == 0) {
                     std::vector<std::string> configs(configs_if);
-                    ret.erase(cfg(configs, userDefines));
+                    eraseConfig(ret, cfg(configs, userDefines), record);
                     configs[configs.size() - 1U] = last.substr(0,last.size()-2U);
                     if (configs.size() == 1U)
-                        ret.erase("");
+                        eraseConfig(ret, "", record);
                     if (!elseError.empty())
                         elseError += ';';
                     elseError += cfg(configs, userDefines);
@@ -415,14 +430,34 @@ static void getConfigs(const simplecpp::TokenList &tokens, std::set<std::string>
             }
         } else if (cmdtok->str() == "define" && sameline(tok, cmdtok->next) && cmdtok->next->name) {
             defined.insert(cmdtok->next->str());
+            if (record)
+                record->defines.push_back(cmdtok->next->str());
         }
     }
     if (!elseError.empty())
-        ret.insert(elseError);
+        insertConfig(ret, elseError, record);
 }
 
 
-std::set<std::string> Preprocessor::getConfigs(const simplecpp::TokenList &tokens) const
+/** The macros that are used in the conditions of a header */
+static std::set<std::string> conditionNames(const simplecpp::TokenList &tokens)
+{
+    std::set<std::string> ret;
+    for (const simplecpp::Token *tok = tokens.cfront(); tok; tok = tok->next) {
+        if (tok->op != '#' || sameline(tok->previous, tok))
+            continue;
+        const simplecpp::Token *cmdtok = tok->next;
+        if (!sameline(tok, cmdtok) || (cmdtok->str().compare(0,2,"if") != 0 && cmdtok->str() != "elif"))
+            continue;
+        for (const simplecpp::Token *cond = cmdtok->next; sameline(tok, cond); cond = cond->next) {
+            if (cond->name)
+                ret.insert(cond->str());
+        }
+    }
+    return ret;
+}
+
+std::set<std::string> Preprocessor::getConfigs(const simplecpp::TokenList &tokens, ConfigsCache *configsCache) const
 {
     std::set<std::string> ret = { "" };
     if (!tokens.cfront())
@@ -430,11 +465,53 @@ std::set<std::string> Preprocessor::getConfigs(const simplecpp::TokenList &token
 
     std::set<std::string> defined = { "__cplusplus" };
 
-    ::getConfigs(tokens, defined, mSettings.userDefines, mSettings.userUndefs, ret);
+    ::getConfigs(tokens, defined, mSettings.userDefines, mSettings.userUndefs, ret, nullptr);
+
+    std::map<std::string, ConfigsCache::Header> *headers = nullptr;
+    if (configsCache)
+        headers = &configsCache->headers[std::make_pair(mSettings.userDefines, mSettings.userUndefs)];
 
     for (std::map<std::string, simplecpp::TokenList*>::const_iterator it = mTokenLists.begin(); it != mTokenLists.end(); ++it) {
-        if (!mSettings.configurationExcluded(it->first))
-            ::getConfigs(*(it->second), defined, mSettings.userDefines, mSettings.userUndefs, ret);
+        if (mSettings.configurationExcluded(it->first))
+            continue;
+        if (!headers) {
+            ::getConfigs(*(it->second), defined, mSettings.userDefines, mSettings.userUndefs, ret, nullptr);
+            continue;
+        }
+
+        // The configurations of a header only depend on its directives and
+        // on which of the macros in its conditions are already defined
+        ConfigsCache::Header &header = (*headers)[it->first];
+        const std::uint64_t hash = it->second->dataHash();
+        if (header.configs.empty() || header.hash != hash) {
+            header.hash = hash;
+            header.conditionNames = conditionNames(*(it->second));
+            header.configs.clear();
+        }
+        std::vector<std::string> definedInConditions;
+        for (const std::string &name : header.conditionNames) {
+            if (defined.find(name) != defined.end())
+                definedInConditions.push_back(name);
+        }
+
+        std::vector<ConfigsCache::HeaderConfigs>::const_iterator cached = header.configs.begin();
+        while (cached != header.configs.end() && cached->definedInConditions != definedInConditions)
+            ++cached;
+        if (cached == header.configs.end()) {
+            ConfigsCache::HeaderConfigs record;
+            record.definedInConditions.swap(definedInConditions);
+            ::getConfigs(*(it->second), defined, mSettings.userDefines, mSettings.userUndefs, ret, &record);
+            header.configs.push_back(std::move(record));
+            continue;
+        }
+
+        for (const std::pair<bool, std::string> &change : cached->changes) {
+            if (change.first)
+                ret.insert(change.second);
+            else
+                ret.erase(change.second);
+        }
+        defined.insert(cached->defines.begin(), cached->defines.end());
     }
 
     return ret;
@@ -847,76 +924,25 @@ void Preprocessor::dump(std::ostream &out) const
     out << "  </directivelist>" << std::endl;
 }
 
-static const std::uint32_t crc32Table[] = {
-    0x00000000, 0x77073096, 0xee0e612c, 0x990951ba, 0x076dc419, 0x706af48f,
-    0xe963a535, 0x9e6495a3, 0x0edb8832, 0x79dcb8a4, 0xe0d5e91e, 0x97d2d988,
-    0x09b64c2b, 0x7eb17cbd, 0xe7b82d07, 0x90bf1d91, 0x1db71064, 0x6ab020f2,
-    0xf3b97148, 0x84be41de, 0x1adad47d, 0x6ddde4eb, 0xf4d4b551, 0x83d385c7,
-    0x136c9856, 0x646ba8c0, 0xfd62f97a, 0x8a65c9ec, 0x14015c4f, 0x63066cd9,
-    0xfa0f3d63, 0x8d080df5, 0x3b6e20c8, 0x4c69105e, 0xd56041e4, 0xa2677172,
-    0x3c03e4d1, 0x4b04d447, 0xd20d85fd, 0xa50ab56b, 0x35b5a8fa, 0x42b2986c,
-    0xdbbbc9d6, 0xacbcf940, 0x32d86ce3, 0x45df5c75, 0xdcd60dcf, 0xabd13d59,
-    0x26d930ac, 0x51de003a, 0xc8d75180, 0xbfd06116, 0x21b4f4b5, 0x56b3c423,
-    0xcfba9599, 0xb8bda50f, 0x2802b89e, 0x5f058808, 0xc60cd9b2, 0xb10be924,
-    0x2f6f7c87, 0x58684c11, 0xc1611dab, 0xb6662d3d, 0x76dc4190, 0x01db7106,
-    0x98d220bc, 0xefd5102a, 0x71b18589, 0x06b6b51f, 0x9fbfe4a5, 0xe8b8d433,
-    0x7807c9a2, 0x0f00f934, 0x9609a88e, 0xe10e9818, 0x7f6a0dbb, 0x086d3d2d,
-    0x91646c97, 0xe6635c01, 0x6b6b51f4, 0x1c6c6162, 0x856530d8, 0xf262004e,
-    0x6c0695ed, 0x1b01a57b, 0x8208f4c1, 0xf50fc457, 0x65b0d9c6, 0x12b7e950,
-    0x8bbeb8ea, 0xfcb9887c, 0x62dd1ddf, 0x15da2d49, 0x8cd37cf3, 0xfbd44c65,
-    0x4db26158, 0x3ab551ce, 0xa3bc0074, 0xd4bb30e2, 0x4adfa541, 0x3dd895d7,
-    0xa4d1c46d, 0xd3d6f4fb, 0x4369e96a, 0x346ed9fc, 0xad678846, 0xda60b8d0,
-    0x44042d73, 0x33031de5, 0xaa0a4c5f, 0xdd0d7cc9, 0x5005713c, 0x270241aa,
-    0xbe0b1010, 0xc90c2086, 0x5768b525, 0x206f85b3, 0xb966d409, 0xce61e49f,
-    0x5edef90e, 0x29d9c998, 0xb0d09822, 0xc7d7a8b4, 0x59b33d17, 0x2eb40d81,
-    0xb7bd5c3b, 0xc0ba6cad, 0xedb88320, 0x9abfb3b6, 0x03b6e20c, 0x74b1d29a,
-    0xead54739, 0x9dd277af, 0x04db2615, 0x73dc1683, 0xe3630b12, 0x94643b84,
-    0x0d6d6a3e, 0x7a6a5aa8, 0xe40ecf0b, 0x9309ff9d, 0x0a00ae27, 0x7d079eb1,
-    0xf00f9344, 0x8708a3d2, 0x1e01f268, 0x6906c2fe, 0xf762575d, 0x806567cb,
-    0x196c3671, 0x6e6b06e7, 0xfed41b76, 0x89d32be0, 0x10da7a5a, 0x67dd4acc,
-    0xf9b9df6f, 0x8ebeeff9, 0x17b7be43, 0x60b08ed5, 0xd6d6a3e8, 0xa1d1937e,
-    0x38d8c2c4, 0x4fdff252, 0xd1bb67f1, 0xa6bc5767, 0x3fb506dd, 0x48b2364b,
-    0xd80d2bda, 0xaf0a1b4c, 0x36034af6, 0x41047a60, 0xdf60efc3, 0xa867df55,
-    0x316e8eef, 0x4669be79, 0xcb61b38c, 0xbc66831a, 0x256fd2a0, 0x5268e236,
-    0xcc0c7795, 0xbb0b4703, 0x220216b9, 0x5505262f, 0xc5ba3bbe, 0xb2bd0b28,
-    0x2bb45a92, 0x5cb36a04, 0xc2d7ffa7, 0xb5d0cf31, 0x2cd99e8b, 0x5bdeae1d,
-    0x9b64c2b0, 0xec63f226, 0x756aa39c, 0x026d930a, 0x9c0906a9, 0xeb0e363f,
-    0x72076785, 0x05005713, 0x95bf4a82, 0xe2b87a14, 0x7bb12bae, 0x0cb61b38,
-    0x92d28e9b, 0xe5d5be0d, 0x7cdcefb7, 0x0bdbdf21, 0x86d3d2d4, 0xf1d4e242,
-    0x68ddb3f8, 0x1fda836e, 0x81be16cd, 0xf6b9265b, 0x6fb077e1, 0x18b74777,
-    0x88085ae6, 0xff0f6a70, 0x66063bca, 0x11010b5c, 0x8f659eff, 0xf862ae69,
-    0x616bffd3, 0x166ccf45, 0xa00ae278, 0xd70dd2ee, 0x4e048354, 0x3903b3c2,
-    0xa7672661, 0xd06016f7, 0x4969474d, 0x3e6e77db, 0xaed16a4a, 0xd9d65adc,
-    0x40df0b66, 0x37d83bf0, 0xa9bcae53, 0xdebb9ec5, 0x47b2cf7f, 0x30b5ffe9,
-    0xbdbdf21c, 0xcabac28a, 0x53b39330, 0x24b4a3a6, 0xbad03605, 0xcdd70693,
-    0x54de5729, 0x23d967bf, 0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94,
-    0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d
-};
-
-static std::uint32_t crc32(const std::string &data)
-{
-    std::uint32_t crc = ~0U;
-    for (std::string::const_iterator c = data.begin(); c != data.end(); ++c) {
-        crc = crc32Table[(crc ^ (unsigned char)(*c)) & 0xFF] ^ (crc >> 8);
-    }
-    return crc ^ ~0U;
-}
-
-unsigned int Preprocessor::calculateChecksum(const simplecpp::TokenList &tokens1, const std::string &toolinfo) const
-{
-    std::ostringstream ostr;
-    ostr << toolinfo << '\n';
-    for (const simplecpp::Token *tok = tokens1.cfront(); tok; tok = tok->next) {
-        if (!tok->comment)
-            ostr << tok->str();
-    }
-    for (std::map<std::string, simplecpp::TokenList *>::const_iterator it = mTokenLists.begin(); it != mTokenLists.end(); ++it) {
-        for (const simplecpp::Token *tok = it->second->cfront(); tok; tok = tok->next) {
-            if (!tok->comment)
-                ostr << tok->str();
-        }
+static void hashTokens(std::uint64_t &hash, const simplecpp::TokenList &tokens)
+{
+    for (const simplecpp::Token *tok = tokens.cfront(); tok; tok = tok->next) {
+        if (tok->comment)
+            continue;
+        fnv1a64(hash, tok->str());
+        // separate tokens so "a bc" and "ab c" get different hashes
+        hash ^= 0xffU;
+        hash *= 0x100000001b3ULL;
     }
-    return crc32(ostr.str());
+}
+
+unsigned long long Preprocessor::calculateChecksum(const simplecpp::TokenList &tokens1, const std::string &toolinfo) const
+{
+    std::uint64_t hash = fnv1a64(toolinfo);
+    hashTokens(hash, tokens1);
+    for (std::map<std::string, simplecpp::TokenList *>::const_iterator it = mTokenLists.begin(); it != mTokenLists.end(); ++it)
+        hashTokens(hash, *it->second);
+    return hash;
 }
 
 void Preprocessor::simplifyPragmaAsm(simplecpp::TokenList *tokenList)
@@ -24,11 +24,13 @@
 #include "config.h"
 
 #include <simplecpp.h>
+#include <cstdint>
 #include <istream>
 #include <list>
 #include <map>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 class ErrorLogger;
@@ -61,6 +63,39 @@ public:
 /// @addtogroup Core
 /// @{
 
+/**
+ * Configurations that headers contribute in Preprocessor::getConfigs(),
+ * shared by the source files that include the same headers.
+ */
+class CPPCHECKLIB ConfigsCache {
+public:
+    struct HeaderConfigs {
+        /** the macros in the conditions of the header that are already defined */
+        std::vector<std::string> definedInConditions;
+
+        /** configurations that are added (true) or removed (false), in order */
+        std::vector<std::pair<bool, std::string>> changes;
+
+        /** macros that the header defines */
+        std::vector<std::string> defines;
+    };
+
+    struct Header {
+        Header() : hash(0) {}
+
+        /** simplecpp hash of the header data, the cached data is dropped when the header changes */
+        std::uint64_t hash;
+
+        /** the macros in the conditions of the header */
+        std::set<std::string> conditionNames;
+
+        std::vector<HeaderConfigs> configs;
+    };
+
+    /** The headers, for each set of -D and -U options that the configurations were calculated with */
+    std::map<std::pair<std::string, std::set<std::string>>, std::map<std::string, Header>> headers;
+};
+
 /**
  * @brief The cppcheck preprocessor.
  * The preprocessor has special functionality for extracting the various ifdef
@@ -96,7 +131,7 @@ public:
         return mDirectives;
     }
 
-    std::set<std::string> getConfigs(const simplecpp::TokenList &tokens) const;
+    std::set<std::string> getConfigs(const simplecpp::TokenList &tokens, ConfigsCache *configsCache = nullptr) const;
 
     void loadFiles(const simplecpp::TokenList &rawtokens, std::vector<std::string> &files);
 
@@ -164,13 +199,14 @@ public:
     void validateCfgError(const std::string &file, const unsigned int line, const std::string &cfg, const std::string &macro);
 
     /**
-     * Calculate CRC32 checksum. Using toolinfo, tokens1, filedata.
+     * Calculate 64-bit checksum. Using toolinfo, tokens1, filedata.
+     * The tokens are hashed directly, no intermediate string is built.
      *
      * @param tokens1    Sourcefile tokens
      * @param toolinfo   Arbitrary extra toolinfo
-     * @return CRC32 checksum
+     * @return 64-bit FNV-1a checksum
      */
-    unsigned int calculateChecksum(const simplecpp::TokenList &tokens1, const std::string &toolinfo) const;
+    unsigned long long calculateChecksum(const simplecpp::TokenList &tokens1, const std::string &toolinfo) const;
 
     void simplifyPragmaAsm(simplecpp::TokenList *tokenList);
 
@@ -38,10 +38,12 @@ Settings::Settings()
       force(false),
       relativePaths(false),
       xml(false), xml_version(2),
+      sarif(false),
       jobs(1),
       loadAverage(0),
       exitCode(0),
       showtime(SHOWTIME_NONE),
+      showmemory(SHOWTIME_NONE),
       preprocessOnly(false),
       maxConfigs(12),
       enforcedLang(None),
@@ -31,6 +31,7 @@
 #include "timer.h"
 
 #include <list>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -38,6 +39,7 @@
 namespace ValueFlow {
     class Value;
 }
+class RulePatterns;
 
 /// @addtogroup Core
 /// @{
@@ -145,6 +147,9 @@ public:
     /** @brief XML version (--xml-version=..) */
     int xml_version;
 
+    /** @brief write SARIF results (--sarif) */
+    bool sarif;
+
     /** @brief How many processes/threads should do checking at the same
         time. Default is 1. (-j N) */
     unsigned int jobs;
@@ -167,6 +172,9 @@ public:
     /** @brief show timing information (--showtime=file|summary|top5) */
     SHOWTIME_MODES showtime;
 
+    /** @brief show memory usage and data counts per phase (--showmemory=file|summary|top5) */
+    SHOWTIME_MODES showmemory;
+
     /** @brief Using -E for debugging purposes */
     bool preprocessOnly;
 
@@ -268,6 +276,12 @@ public:
      */
     std::list<Rule> rules;
 
+    /**
+     * @brief The compiled patterns of the rules, see CppCheck::compileRules().
+     * They are only read, copies of the settings share them.
+     */
+    std::shared_ptr<const RulePatterns> rulePatterns;
+
     /** Is the 'configuration checking' wanted? */
     bool checkConfiguration;
 
@@ -486,6 +486,31 @@ static void setScopeInfo(const Token *tok, std::list<ScopeInfo2> *scopeInfo)
     }
 }
 
+/** Is tok the '{' of a function body or of an initializer list? */
+static bool isFunctionBodyOrInitList(const Token *tok)
+{
+    if (tok->str() != "{" || !tok->previous())
+        return false;
+    const Token *end = tok->previous();
+    if (end->str() == "=")
+        return true;
+    if (end->str() == "const")
+        end = end->previous();
+    if (!end || end->str() != ")" || !Token::Match(end->link()->previous(), "%name%"))
+        return false;
+    // The head of a class can also end with a ')', as in alignas(8),
+    // decltype(..) or a macro. A function body follows a function head.
+    for (const Token *tok2 = end->link()->previous(); tok2 && !Token::Match(tok2, "[;{}]"); tok2 = tok2->previous()) {
+        if (tok2->str() == ")")
+            tok2 = tok2->link();
+        else if (tok2->str() == ">" && tok2->findOpeningBracket())
+            tok2 = tok2->findOpeningBracket();
+        else if (Token::Match(tok2, "class|struct|union|enum|namespace"))
+            return false;
+    }
+    return true;
+}
+
 bool TemplateSimplifier::getTemplateDeclarations()
 {
     bool codeWithTemplates = false;
@@ -1193,6 +1218,11 @@ void TemplateSimplifier::expandTemplate(
         }
         if (Token::Match(tok3, "(|["))
             tok3 = tok3->link();
+        // Skip function bodies and initializer lists, there are no template
+        // declarations in them. The statement that starts an out of line
+        // member function is before its body.
+        else if (isFunctionBodyOrInitList(tok3))
+            tok3 = tok3->link();
 
         // Start of template..
         if (tok3 == templateDeclarationToken) {
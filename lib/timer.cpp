@@ -31,12 +31,44 @@
         - for Timer* classes
 */
 
+bool MemoryCounters::supported = false;
+bool MemoryCounters::active = false;
+unsigned long long MemoryCounters::allocations = 0;
+unsigned long long MemoryCounters::allocatedBytes = 0;
+long long MemoryCounters::liveBytes = 0;
+long long MemoryCounters::peakBytes = 0;
+
 namespace {
     typedef std::pair<std::string, struct TimerResultsData> dataElementType;
     bool more_second_sec(const dataElementType& lhs, const dataElementType& rhs)
     {
         return lhs.second.seconds() > rhs.second.seconds();
     }
+
+    bool more_allocated_bytes(const dataElementType& lhs, const dataElementType& rhs)
+    {
+        return lhs.second.mMemory.allocatedBytes > rhs.second.mMemory.allocatedBytes;
+    }
+
+    std::string kilobytes(long long bytes)
+    {
+        return std::to_string(bytes / 1024) + " kB";
+    }
+
+    std::string memoryUsageString(const MemoryUsage &usage)
+    {
+        return std::to_string(usage.allocations) + " allocation(s), " +
+               kilobytes((long long)usage.allocatedBytes) + " allocated, peak " +
+               kilobytes(usage.peakBytes);
+    }
+}
+
+std::string DataCounts::toString() const
+{
+    return std::to_string(tokens) + " token(s), " +
+           std::to_string(scopes) + " scope(s), " +
+           std::to_string(variables) + " variable(s), " +
+           std::to_string(values) + " value(s)";
 }
 
 void TimerResults::ShowResults(SHOWTIME_MODES mode) const
@@ -52,6 +84,8 @@ void TimerResults::ShowResults(SHOWTIME_MODES mode) const
 
     size_t ordinal = 1; // maybe it would be nice to have an ordinal in output later!
     for (std::vector<dataElementType>::const_iterator iter=data.begin() ; iter!=data.end(); ++iter) {
+        if (iter->second.mNumberOfResults == 0) // only memory results
+            continue;
         const double sec = iter->second.seconds();
         const double secAverage = sec / (double)(iter->second.mNumberOfResults);
         overallData.mClocks += iter->second.mClocks;
@@ -63,6 +97,40 @@ void TimerResults::ShowResults(SHOWTIME_MODES mode) const
 
     const double secOverall = overallData.seconds();
     std::cout << "Overall time: " << secOverall << "s" << std::endl;
+
+    for (std::map<std::string, long>::const_iterator it = mSkipped.begin(); it != mSkipped.end(); ++it)
+        std::cout << it->first << ": skipped " << it->second << " time(s)" << std::endl;
+}
+
+void TimerResults::ShowMemoryResults(SHOWTIME_MODES mode) const
+{
+    if (mode == SHOWTIME_NONE || mode == SHOWTIME_FILE)
+        return;
+
+    std::cout << std::endl;
+    if (MemoryCounters::supported) {
+        std::vector<dataElementType> data;
+        for (std::map<std::string, struct TimerResultsData>::const_iterator iter = mResults.begin(); iter != mResults.end(); ++iter) {
+            if (iter->second.mMemory.allocations > 0)
+                data.push_back(*iter);
+        }
+        std::sort(data.begin(), data.end(), more_allocated_bytes);
+
+        size_t ordinal = 1;
+        for (std::vector<dataElementType>::const_iterator iter=data.begin() ; iter!=data.end(); ++iter) {
+            if ((mode != SHOWTIME_TOP5) || (ordinal<=5)) {
+                std::cout << iter->first << ": " << memoryUsageString(iter->second.mMemory)
+                          << " (" << iter->second.mNumberOfMemoryResults << " result(s))" << std::endl;
+            }
+            ++ordinal;
+        }
+        std::cout << "Overall peak memory: " << kilobytes(MemoryCounters::peakBytes) << std::endl;
+    } else {
+        std::cout << "Allocation tracking is not supported on this platform." << std::endl;
+    }
+    std::cout << "Total: " << mTotalCounts.toString() << std::endl;
+    if (!mLargestFile.empty())
+        std::cout << "Largest: " << mLargestFile << ": " << mLargestCounts.toString() << std::endl;
 }
 
 void TimerResults::AddResults(const std::string& str, std::clock_t clocks)
@@ -71,15 +139,54 @@ void TimerResults::AddResults(const std::string& str, std::clock_t clocks)
     mResults[str].mNumberOfResults++;
 }
 
-Timer::Timer(const std::string& str, unsigned int showtimeMode, TimerResultsIntf* timerResults)
+void TimerResults::AddMemoryResults(const std::string& str, const MemoryUsage &usage)
+{
+    TimerResultsData &data = mResults[str];
+    data.mMemory.allocations += usage.allocations;
+    data.mMemory.allocatedBytes += usage.allocatedBytes;
+    data.mMemory.peakBytes = std::max(data.mMemory.peakBytes, usage.peakBytes);
+    data.mNumberOfMemoryResults++;
+}
+
+void TimerResults::AddSkipped(const std::string& str)
+{
+    mSkipped[str]++;
+}
+
+void TimerResults::AddCounts(const std::string& file, const DataCounts &counts)
+{
+    mTotalCounts.tokens += counts.tokens;
+    mTotalCounts.scopes += counts.scopes;
+    mTotalCounts.variables += counts.variables;
+    mTotalCounts.values += counts.values;
+    if (mLargestFile.empty() || counts.tokens > mLargestCounts.tokens) {
+        mLargestCounts = counts;
+        mLargestFile = file;
+    }
+}
+
+Timer::Timer(const std::string& str, unsigned int showtimeMode, TimerResultsIntf* timerResults, unsigned int showmemoryMode)
     : mStr(str)
     , mTimerResults(timerResults)
     , mStart(0)
     , mShowTimeMode(showtimeMode)
+    , mShowMemoryMode(MemoryCounters::supported ? showmemoryMode : (unsigned int)SHOWTIME_NONE)
     , mStopped(false)
+    , mStartAllocations(0)
+    , mStartAllocatedBytes(0)
+    , mStartLiveBytes(0)
+    , mOuterPeakBytes(0)
 {
     if (showtimeMode != SHOWTIME_NONE)
         mStart = std::clock();
+    if (mShowMemoryMode != SHOWTIME_NONE) {
+        mStartAllocations = MemoryCounters::allocations;
+        mStartAllocatedBytes = MemoryCounters::allocatedBytes;
+        mStartLiveBytes = MemoryCounters::liveBytes;
+        // Track the peak of this phase, the outer peak is restored in Stop()
+        mOuterPeakBytes = MemoryCounters::peakBytes;
+        MemoryCounters::peakBytes = MemoryCounters::liveBytes;
+    }
 }
 
 Timer::~Timer()
@@ -102,5 +209,18 @@ void Timer::Stop()
         }
     }
 
+    if ((mShowMemoryMode != SHOWTIME_NONE) && !mStopped) {
+        MemoryUsage usage;
+        usage.allocations = MemoryCounters::allocations - mStartAllocations;
+        usage.allocatedBytes = MemoryCounters::allocatedBytes - mStartAllocatedBytes;
+        usage.peakBytes = MemoryCounters::peakBytes - mStartLiveBytes;
+        MemoryCounters::peakBytes = std::max(MemoryCounters::peakBytes, mOuterPeakBytes);
+
+        if (mShowMemoryMode == SHOWTIME_FILE)
+            std::cout << mStr << ": " << memoryUsageString(usage) << std::endl;
+        else if (mTimerResults)
+            mTimerResults->AddMemoryResults(mStr, usage);
+    }
+
     mStopped = true;
 }
@@ -22,6 +22,7 @@
 
 #include "config.h"
 
+#include <cstddef>
 #include <ctime>
 #include <map>
 #include <string>
@@ -33,20 +34,84 @@ enum SHOWTIME_MODES {
     SHOWTIME_TOP5
 };
 
+/**
+ * Allocation counters for --showmemory. They are updated by the global
+ * operator new/delete of the cppcheck binary (cli/newdelete.cpp) while
+ * active is set. In other programs they stay 0 and supported is false.
+ * They are not synchronized, so --showmemory is not allowed with worker
+ * threads (-j on Windows).
+ */
+class CPPCHECKLIB MemoryCounters {
+public:
+    static bool supported;
+    static bool active;
+    static unsigned long long allocations;
+    static unsigned long long allocatedBytes;
+    static long long liveBytes;
+    static long long peakBytes;
+
+    static void allocated(std::size_t size) {
+        ++allocations;
+        allocatedBytes += size;
+        liveBytes += (long long)size;
+        if (liveBytes > peakBytes)
+            peakBytes = liveBytes;
+    }
+
+    static void deallocated(std::size_t size) {
+        liveBytes -= (long long)size;
+    }
+};
+
+/** Memory used by one run of a phase */
+struct MemoryUsage {
+    unsigned long long allocations;
+    unsigned long long allocatedBytes;
+    /** Highest live memory during the phase, above the memory in use when it started */
+    long long peakBytes;
+
+    MemoryUsage()
+        : allocations(0)
+        , allocatedBytes(0)
+        , peakBytes(0) {
+    }
+};
+
+/** Size of the data structures of a checked configuration, for --showmemory */
+struct DataCounts {
+    std::size_t tokens;
+    std::size_t scopes;
+    std::size_t variables;
+    std::size_t values;
+
+    DataCounts()
+        : tokens(0)
+        , scopes(0)
+        , variables(0)
+        , values(0) {
+    }
+
+    std::string toString() const;
+};
+
 class CPPCHECKLIB TimerResultsIntf {
 public:
     virtual ~TimerResultsIntf() { }
 
     virtual void AddResults(const std::string& str, std::clock_t clocks) = 0;
+    virtual void AddMemoryResults(const std::string& str, const MemoryUsage &usage) = 0;
 };
 
 struct TimerResultsData {
     std::clock_t mClocks;
     long mNumberOfResults;
+    MemoryUsage mMemory;
+    long mNumberOfMemoryResults;
 
     TimerResultsData()
         : mClocks(0)
-        , mNumberOfResults(0) {
+        , mNumberOfResults(0)
+        , mNumberOfMemoryResults(0) {
     }
 
     double seconds() const {
@@ -61,15 +126,28 @@ public:
     }
 
     void ShowResults(SHOWTIME_MODES mode) const;
+    void ShowMemoryResults(SHOWTIME_MODES mode) const;
     virtual void AddResults(const std::string& str, std::clock_t clocks) override;
+    virtual void AddMemoryResults(const std::string& str, const MemoryUsage &usage) override;
+
+    /** Add the data counts of a checked configuration, for the --showmemory summary */
+    void AddCounts(const std::string& file, const DataCounts &counts);
+
+    /** A phase was not needed and skipped, for the --showtime summary */
+    void AddSkipped(const std::string& str);
 
 private:
     std::map<std::string, struct TimerResultsData> mResults;
+    std::map<std::string, long> mSkipped;
+
+    DataCounts mTotalCounts;
+    DataCounts mLargestCounts;
+    std::string mLargestFile;
 };
 
 class CPPCHECKLIB Timer {
 public:
-    Timer(const std::string& str, unsigned int showtimeMode, TimerResultsIntf* timerResults = nullptr);
+    Timer(const std::string& str, unsigned int showtimeMode, TimerResultsIntf* timerResults = nullptr, unsigned int showmemoryMode = SHOWTIME_NONE);
     ~Timer();
     void Stop();
 
@@ -81,7 +159,14 @@ private:
     TimerResultsIntf* mTimerResults;
     std::clock_t mStart;
     const unsigned int mShowTimeMode;
+    const unsigned int mShowMemoryMode;
     bool mStopped;
+
+    /** Counters when the timer was started, for --showmemory */
+    unsigned long long mStartAllocations;
+    unsigned long long mStartAllocatedBytes;
+    long long mStartLiveBytes;
+    long long mOuterPeakBytes;
 };
 //---------------------------------------------------------------------------
 #endif // timerH
@@ -33,7 +33,7 @@
 #include <stack>
 #include <utility>
 
-const std::list<ValueFlow::Value> TokenImpl::mEmptyValueList;
+const std::vector<ValueFlow::Value> TokenImpl::mEmptyValueList;
 
 Token::Token(TokensFrontBack *tokensFrontBack) :
     mTokensFrontBack(tokensFrontBack),
@@ -67,6 +67,7 @@ static const std::set<std::string> controlFlowKeywords = {
 
 void Token::update_property_info()
 {
+    changed();
     setFlag(fIsControlFlowKeyword, controlFlowKeywords.find(mStr) != controlFlowKeywords.end());
 
     if (!mStr.empty()) {
@@ -190,6 +191,7 @@ std::string Token::strValue() const
 
 void Token::deleteNext(unsigned long index)
 {
+    changed();
     while (mNext && index) {
         Token *n = mNext;
 
@@ -210,6 +212,7 @@ void Token::deleteNext(unsigned long index)
 
 void Token::deletePrevious(unsigned long index)
 {
+    changed();
     while (mPrevious && index) {
         Token *p = mPrevious;
 
@@ -230,6 +233,7 @@ void Token::deletePrevious(unsigned long index)
 
 void Token::swapWithNext()
 {
+    changed();
     if (mNext) {
         std::swap(mStr, mNext->mStr);
         std::swap(mTokType, mNext->mTokType);
@@ -252,6 +256,7 @@ void Token::swapWithNext()
 
 void Token::takeData(Token *fromToken)
 {
+    changed();
     mStr = fromToken->mStr;
     tokType(fromToken->mTokType);
     mFlags = fromToken->mFlags;
@@ -1470,7 +1475,7 @@ const ValueFlow::Value * Token::getValueLE(const MathLib::bigint val, const Sett
     if (!mImpl->mValues)
         return nullptr;
     const ValueFlow::Value *ret = nullptr;
-    std::list<ValueFlow::Value>::const_iterator it;
+    std::vector<ValueFlow::Value>::const_iterator it;
     for (it = mImpl->mValues->begin(); it != mImpl->mValues->end(); ++it) {
         if (it->isIntValue() && it->intvalue <= val) {
             if (!ret || ret->isInconclusive() || (ret->condition && !it->isInconclusive()))
@@ -1493,7 +1498,7 @@ const ValueFlow::Value * Token::getValueGE(const MathLib::bigint val, const Sett
     if (!mImpl->mValues)
         return nullptr;
     const ValueFlow::Value *ret = nullptr;
-    std::list<ValueFlow::Value>::const_iterator it;
+    std::vector<ValueFlow::Value>::const_iterator it;
     for (it = mImpl->mValues->begin(); it != mImpl->mValues->end(); ++it) {
         if (it->isIntValue() && it->intvalue >= val) {
             if (!ret || ret->isInconclusive() || (ret->condition && !it->isInconclusive()))
@@ -1516,7 +1521,7 @@ const ValueFlow::Value * Token::getInvalidValue(const Token *ftok, unsigned int
     if (!mImpl->mValues || !settings)
         return nullptr;
     const ValueFlow::Value *ret = nullptr;
-    std::list<ValueFlow::Value>::const_iterator it;
+    std::vector<ValueFlow::Value>::const_iterator it;
     for (it = mImpl->mValues->begin(); it != mImpl->mValues->end(); ++it) {
         if ((it->isIntValue() && !settings->library.isIntArgValid(ftok, argnr, it->intvalue)) ||
             (it->isFloatValue() && !settings->library.isFloatArgValid(ftok, argnr, it->floatValue))) {
@@ -1541,7 +1546,7 @@ const Token *Token::getValueTokenMinStrSize() const
         return nullptr;
     const Token *ret = nullptr;
     std::size_t minsize = ~0U;
-    std::list<ValueFlow::Value>::const_iterator it;
+    std::vector<ValueFlow::Value>::const_iterator it;
     for (it = mImpl->mValues->begin(); it != mImpl->mValues->end(); ++it) {
         if (it->isTokValue() && it->tokvalue && it->tokvalue->tokType() == Token::eString) {
             const std::size_t size = getStrSize(it->tokvalue);
@@ -1560,7 +1565,7 @@ const Token *Token::getValueTokenMaxStrLength() const
         return nullptr;
     const Token *ret = nullptr;
     std::size_t maxlength = 0U;
-    std::list<ValueFlow::Value>::const_iterator it;
+    std::vector<ValueFlow::Value>::const_iterator it;
     for (it = mImpl->mValues->begin(); it != mImpl->mValues->end(); ++it) {
         if (it->isTokValue() && it->tokvalue && it->tokvalue->tokType() == Token::eString) {
             const std::size_t length = getStrLength(it->tokvalue);
@@ -1584,7 +1589,7 @@ const Token *Token::getValueTokenDeadPointer() const
 {
     const Scope * const functionscope = getfunctionscope(this->scope());
 
-    std::list<ValueFlow::Value>::const_iterator it;
+    std::vector<ValueFlow::Value>::const_iterator it;
     for (it = values().begin(); it != values().end(); ++it) {
         // Is this a pointer alias?
         if (!it->isTokValue() || (it->tokvalue && it->tokvalue->str() != "&"))
@@ -1617,9 +1622,9 @@ bool Token::addValue(const ValueFlow::Value &value)
 {
     if (value.isKnown() && mImpl->mValues) {
         // Clear all other values of the same type since value is known
-        mImpl->mValues->remove_if([&](const ValueFlow::Value & x) {
+        mImpl->mValues->erase(std::remove_if(mImpl->mValues->begin(), mImpl->mValues->end(), [&](const ValueFlow::Value & x) {
             return x.valueType == value.valueType;
-        });
+        }), mImpl->mValues->end());
     }
 
     if (mImpl->mValues) {
@@ -1629,7 +1634,7 @@ bool Token::addValue(const ValueFlow::Value &value)
             return false;
 
         // if value already exists, don't add it again
-        std::list<ValueFlow::Value>::iterator it;
+        std::vector<ValueFlow::Value>::iterator it;
         for (it = mImpl->mValues->begin(); it != mImpl->mValues->end(); ++it) {
             // different intvalue => continue
             if (it->intvalue != value.intvalue)
@@ -1659,7 +1664,7 @@ bool Token::addValue(const ValueFlow::Value &value)
             if (v.varId == 0)
                 v.varId = mImpl->mVarId;
             if (v.isKnown() && v.isIntValue())
-                mImpl->mValues->push_front(v);
+                mImpl->mValues->insert(mImpl->mValues->begin(), v);
             else
                 mImpl->mValues->push_back(v);
         }
@@ -1667,7 +1672,7 @@ bool Token::addValue(const ValueFlow::Value &value)
         ValueFlow::Value v(value);
         if (v.varId == 0)
             v.varId = mImpl->mVarId;
-        mImpl->mValues = new std::list<ValueFlow::Value>(1, v);
+        mImpl->mValues = new std::vector<ValueFlow::Value>(1, v);
     }
 
     return true;
@@ -1701,6 +1706,39 @@ void Token::type(const ::Type *t)
         tokType(eName);
 }
 
+void Token::detachAnalysis(TokenAnalysis &analysis)
+{
+    analysis.mAstOperand1 = mImpl->mAstOperand1;
+    analysis.mAstOperand2 = mImpl->mAstOperand2;
+    analysis.mAstParent = mImpl->mAstParent;
+    analysis.mScope = mImpl->mScope;
+    analysis.mFunction = mImpl->mFunction;
+    analysis.mValueType = mImpl->mValueType;
+    analysis.mValues = mImpl->mValues;
+    mImpl->mAstOperand1 = mImpl->mAstOperand2 = mImpl->mAstParent = nullptr;
+    mImpl->mScope = nullptr;
+    mImpl->mFunction = nullptr;
+    mImpl->mValueType = nullptr;
+    mImpl->mValues = nullptr;
+}
+
+void Token::attachAnalysis(const TokenAnalysis &analysis)
+{
+    mImpl->mAstOperand1 = analysis.mAstOperand1;
+    mImpl->mAstOperand2 = analysis.mAstOperand2;
+    mImpl->mAstParent = analysis.mAstParent;
+    mImpl->mScope = analysis.mScope;
+    mImpl->mFunction = analysis.mFunction;
+    mImpl->mValueType = analysis.mValueType;
+    mImpl->mValues = analysis.mValues;
+}
+
+void Token::deleteAnalysis(const TokenAnalysis &analysis)
+{
+    delete analysis.mValueType;
+    delete analysis.mValues;
+}
+
 TokenImpl::~TokenImpl()
 {
     delete mOriginalName;
@@ -48,6 +48,19 @@ class Variable;
 struct TokensFrontBack {
     Token *front;
     Token *back;
+    /** Incremented each time a token of the list is changed, inserted or removed */
+    unsigned long long changes;
+};
+
+/** The AST, symbol database pointers and values of a token, see Token::detachAnalysis() */
+struct TokenAnalysis {
+    Token *mAstOperand1;
+    Token *mAstOperand2;
+    Token *mAstParent;
+    const Scope *mScope;
+    const Function *mFunction; // or the variable, type or enumerator
+    ValueType *mValueType;
+    std::vector<ValueFlow::Value>* mValues;
 };
 
 struct TokenImpl {
@@ -82,9 +95,9 @@ struct TokenImpl {
     // ValueType
     ValueType *mValueType;
 
-    // ValueFlow
-    std::list<ValueFlow::Value>* mValues;
-    static const std::list<ValueFlow::Value> mEmptyValueList;
+    // ValueFlow, kept in a vector since most tokens have only a few values
+    std::vector<ValueFlow::Value>* mValues;
+    static const std::vector<ValueFlow::Value> mEmptyValueList;
 
     /** Bitfield bit count. */
     unsigned char mBits;
@@ -315,6 +328,8 @@ public:
         return mTokType;
     }
     void tokType(Token::Type t) {
+        if (t != mTokType)
+            changed();
         mTokType = t;
 
         const bool memoizedIsName = (mTokType == eName || mTokType == eType || mTokType == eVariable ||
@@ -387,6 +402,8 @@ public:
         return mFlags;
     }
     void flags(const unsigned int flags_) {
+        if (flags_ != mFlags)
+            changed();
         mFlags = flags_;
     }
     bool isUnsigned() const {
@@ -646,6 +663,8 @@ public:
         return mImpl->mVarId;
     }
     void varId(unsigned int id) {
+        if (id != mImpl->mVarId)
+            changed();
         mImpl->mVarId = id;
         if (id != 0) {
             tokType(eVariable);
@@ -722,6 +741,8 @@ public:
      * to.
      */
     void link(Token *linkToToken) {
+        if (linkToToken != mLink)
+            changed();
         mLink = linkToToken;
         if (mStr == "<" || mStr == ">")
             update_property_info();
@@ -894,7 +915,7 @@ public:
         return mImpl->mOriginalName ? *mImpl->mOriginalName : emptyString;
     }
 
-    const std::list<ValueFlow::Value>& values() const {
+    const std::vector<ValueFlow::Value>& values() const {
         return mImpl->mValues ? *mImpl->mValues : mImpl->mEmptyValueList;
     }
 
@@ -903,6 +924,7 @@ public:
      */
     template<typename T>
     void originalName(T&& name) {
+        changed();
         if (!mImpl->mOriginalName)
             mImpl->mOriginalName = new std::string(name);
         else
@@ -977,9 +999,13 @@ public:
 private:
 
     void next(Token *nextToken) {
+        if (nextToken != mNext)
+            changed();
         mNext = nextToken;
     }
     void previous(Token *previousToken) {
+        if (previousToken != mPrevious)
+            changed();
         mPrevious = previousToken;
     }
 
@@ -1055,7 +1081,16 @@ private:
      * @param state_ new state of flag
      */
     void setFlag(unsigned int flag_, bool state_) {
-        mFlags = state_ ? mFlags | flag_ : mFlags & ~flag_;
+        const unsigned int flags_ = state_ ? mFlags | flag_ : mFlags & ~flag_;
+        if (flags_ != mFlags)
+            changed();
+        mFlags = flags_;
+    }
+
+    /** Record a change of the token in the token list */
+    void changed() {
+        if (mTokensFrontBack)
+            ++mTokensFrontBack->changes;
     }
 
     /** Updates internal property cache like _isName or _isBoolean.
@@ -1105,6 +1140,16 @@ public:
         mImpl->mValues = nullptr;
     }
 
+    /**
+     * Move the AST, symbol database pointers and values of the token to
+     * 'analysis'. The token is left without them until attachAnalysis()
+     * puts them back. If they are not put back, deleteAnalysis() must be
+     * used to free them.
+     */
+    void detachAnalysis(TokenAnalysis &analysis);
+    void attachAnalysis(const TokenAnalysis &analysis);
+    static void deleteAnalysis(const TokenAnalysis &analysis);
+
     std::string astString(const char *sep = "") const {
         std::string ret;
         if (mImpl->mAstOperand1)
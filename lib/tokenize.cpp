@@ -147,6 +147,8 @@ Tokenizer::Tokenizer() :
     mSettings(nullptr),
     mErrorLogger(nullptr),
     mSymbolDatabase(nullptr),
+    mAnalysis(ANALYSIS_AST),
+    mAnalysisChanges(0),
     mTemplateSimplifier(nullptr),
     mVarId(0),
     mUnnamedCount(0),
@@ -163,6 +165,8 @@ Tokenizer::Tokenizer(const Settings *settings, ErrorLogger *errorLogger) :
     mSettings(settings),
     mErrorLogger(errorLogger),
     mSymbolDatabase(nullptr),
+    mAnalysis(ANALYSIS_AST),
+    mAnalysisChanges(0),
     mTemplateSimplifier(nullptr),
     mVarId(0),
     mUnnamedCount(0),
@@ -1744,7 +1748,7 @@ void Tokenizer::createTokens(const simplecpp::TokenList *tokenList)
     list.createTokens(tokenList);
 }
 
-bool Tokenizer::simplifyTokens1(const std::string &configuration)
+bool Tokenizer::simplifyTokens1(const std::string &configuration, Analysis analysis)
 {
     // Fill the map mTypeSize..
     fillTypeSizes();
@@ -1754,29 +1758,59 @@ bool Tokenizer::simplifyTokens1(const std::string &configuration)
     if (!simplifyTokenList1(list.getFiles().front().c_str()))
         return false;
 
-    list.createAst();
-    list.validateAst();
+    if (mTimerResults) {
+        Timer t("Tokenizer::simplifyTokens1::createAst", mSettings->showtime, mTimerResults, mSettings->showmemory);
+        list.createAst();
+        list.validateAst();
+    } else {
+        list.createAst();
+        list.validateAst();
+    }
 
-    createSymbolDatabase();
+    mAnalysis = ANALYSIS_AST;
+    analyse(analysis);
 
-    // Use symbol database to identify rvalue references. Split && to & &. This is safe, since it doesn't delete any tokens (which might be referenced by symbol database)
-    for (const Variable* var : mSymbolDatabase->variableList()) {
-        if (var && var->isRValueReference()) {
-            Token* endTok = const_cast<Token*>(var->typeEndToken());
-            endTok->str("&");
-            endTok->astOperand1(nullptr);
-            endTok->astOperand2(nullptr);
-            endTok->insertToken("&");
-            endTok->next()->scope(endTok->scope());
+    return true;
+}
+
+void Tokenizer::analyse(Analysis analysis)
+{
+    if (analysis >= ANALYSIS_SYMBOLDATABASE && mAnalysis < ANALYSIS_SYMBOLDATABASE) {
+        if (mTimerResults) {
+            Timer t("Tokenizer::simplifyTokens1::createSymbolDatabase", mSettings->showtime, mTimerResults, mSettings->showmemory);
+            createSymbolDatabase();
+        } else {
+            createSymbolDatabase();
         }
-    }
+        mAnalysisChanges = list.changes();
 
-    mSymbolDatabase->setValueTypeInTokenList();
-    ValueFlow::setValues(&list, mSymbolDatabase, mErrorLogger, mSettings);
+        // Use symbol database to identify rvalue references. Split && to & &. This is safe, since it doesn't delete any tokens (which might be referenced by symbol database)
+        for (const Variable* var : mSymbolDatabase->variableList()) {
+            if (var && var->isRValueReference()) {
+                Token* endTok = const_cast<Token*>(var->typeEndToken());
+                endTok->str("&");
+                endTok->astOperand1(nullptr);
+                endTok->astOperand2(nullptr);
+                endTok->insertToken("&");
+                endTok->next()->scope(endTok->scope());
+            }
+        }
 
-    printDebugOutput(1);
+        mSymbolDatabase->setValueTypeInTokenList();
+        mAnalysis = ANALYSIS_SYMBOLDATABASE;
+    }
 
-    return true;
+    if (analysis >= ANALYSIS_VALUEFLOW && mAnalysis < ANALYSIS_VALUEFLOW) {
+        if (mTimerResults) {
+            Timer t("Tokenizer::simplifyTokens1::ValueFlow", mSettings->showtime, mTimerResults, mSettings->showmemory);
+            ValueFlow::setValues(&list, mSymbolDatabase, mErrorLogger, mSettings);
+        } else {
+            ValueFlow::setValues(&list, mSymbolDatabase, mErrorLogger, mSettings);
+        }
+        mAnalysis = ANALYSIS_VALUEFLOW;
+
+        printDebugOutput(1);
+    }
 }
 
 bool Tokenizer::tokenize(std::istream &code,
@@ -3600,7 +3634,7 @@ bool Tokenizer::simplifyTokenList1(const char FileName[])
 
     // Bail out if code is garbage
     if (mTimerResults) {
-        Timer t("Tokenizer::tokenize::findGarbageCode", mSettings->showtime, mTimerResults);
+        Timer t("Tokenizer::tokenize::findGarbageCode", mSettings->showtime, mTimerResults, mSettings->showmemory);
         findGarbageCode();
     } else {
         findGarbageCode();
@@ -3770,7 +3804,7 @@ bool Tokenizer::simplifyTokenList1(const char FileName[])
 
     // typedef..
     if (mTimerResults) {
-        Timer t("Tokenizer::tokenize::simplifyTypedef", mSettings->showtime, mTimerResults);
+        Timer t("Tokenizer::tokenize::simplifyTypedef", mSettings->showtime, mTimerResults, mSettings->showmemory);
         simplifyTypedef();
     } else {
         simplifyTypedef();
@@ -3870,7 +3904,12 @@ bool Tokenizer::simplifyTokenList1(const char FileName[])
 
     if (!isC()) {
         // Handle templates..
-        simplifyTemplates();
+        if (mTimerResults) {
+            Timer t("Tokenizer::tokenize::simplifyTemplates", mSettings->showtime, mTimerResults, mSettings->showmemory);
+            simplifyTemplates();
+        } else {
+            simplifyTemplates();
+        }
 
         // The simplifyTemplates have inner loops
         if (mSettings->terminated())
@@ -3898,7 +3937,7 @@ bool Tokenizer::simplifyTokenList1(const char FileName[])
     validate(); // #6772 "segmentation fault (invalid code) in Tokenizer::setVarId"
 
     if (mTimerResults) {
-        Timer t("Tokenizer::tokenize::setVarId", mSettings->showtime, mTimerResults);
+        Timer t("Tokenizer::tokenize::setVarId", mSettings->showtime, mTimerResults, mSettings->showmemory);
         setVarId();
     } else {
         setVarId();
@@ -3946,16 +3985,63 @@ bool Tokenizer::simplifyTokenList1(const char FileName[])
     return true;
 }
 
+namespace {
+    /**
+     * The AST, symbol database and values of the normal token list, taken
+     * out of the tokens while they are simplified. They are put back if
+     * the simplifications don't change the tokens, otherwise they are
+     * deleted.
+     */
+    class DetachedAnalysis {
+    public:
+        DetachedAnalysis(TokenList &list, SymbolDatabase *&symbolDatabase)
+            : mList(list), mSymbolDatabase(symbolDatabase), mDetachedSymbolDatabase(symbolDatabase) {
+            symbolDatabase = nullptr;
+            for (Token *tok = list.front(); tok; tok = tok->next()) {
+                mAnalysis.emplace_back();
+                tok->detachAnalysis(mAnalysis.back());
+            }
+        }
+
+        ~DetachedAnalysis() {
+            discard();
+        }
+
+        /** Put the analysis back, the tokens must be unchanged */
+        void attach() {
+            std::vector<TokenAnalysis>::const_iterator it = mAnalysis.begin();
+            for (Token *tok = mList.front(); tok; tok = tok->next())
+                tok->attachAnalysis(*it++);
+            mAnalysis.clear();
+            mSymbolDatabase = mDetachedSymbolDatabase;
+            mDetachedSymbolDatabase = nullptr;
+        }
+
+        /** Delete the analysis */
+        void discard() {
+            for (const TokenAnalysis &analysis : mAnalysis)
+                Token::deleteAnalysis(analysis);
+            mAnalysis.clear();
+            delete mDetachedSymbolDatabase;
+            mDetachedSymbolDatabase = nullptr;
+        }
+
+    private:
+        TokenList &mList;
+        SymbolDatabase *&mSymbolDatabase;
+        SymbolDatabase *mDetachedSymbolDatabase;
+        std::vector<TokenAnalysis> mAnalysis;
+    };
+}
+
 bool Tokenizer::simplifyTokenList2()
 {
-    // clear the _functionList so it can't contain dead pointers
-    deleteSymbolDatabase();
+    // The rvalue references are split with the help of the symbol database
+    analyse(ANALYSIS_SYMBOLDATABASE);
 
-    // Clear AST,ValueFlow. These will be created again at the end of this function.
-    for (Token *tok = list.front(); tok; tok = tok->next()) {
-        tok->clearAst();
-        tok->clearValueFlow();
-    }
+    // The simplifications don't see the AST, symbol database and values.
+    // If the tokens are not changed, they are reused.
+    DetachedAnalysis detachedAnalysis(list, mSymbolDatabase);
 
     // f(x=g())   =>   x=g(); f(x)
     simplifyAssignmentInFunctionCall();
@@ -4073,15 +4159,24 @@ bool Tokenizer::simplifyTokenList2()
 
     Token::assignProgressValues(list.front());
 
-    list.createAst();
-    // needed for #7208 (garbage code) and #7724 (ast max depth limit)
-    list.validateAst();
+    if (list.changes() == mAnalysisChanges) {
+        // Nothing was simplified, the analysis of the normal token list is reused
+        detachedAnalysis.attach();
+        analyse(ANALYSIS_VALUEFLOW);
+    } else {
+        detachedAnalysis.discard();
+
+        list.createAst();
+        // needed for #7208 (garbage code) and #7724 (ast max depth limit)
+        list.validateAst();
 
-    // Create symbol database and then remove const keywords
-    createSymbolDatabase();
-    mSymbolDatabase->setValueTypeInTokenList();
+        // Create symbol database and then remove const keywords
+        createSymbolDatabase();
+        mSymbolDatabase->setValueTypeInTokenList();
 
-    ValueFlow::setValues(&list, mSymbolDatabase, mErrorLogger, mSettings);
+        ValueFlow::setValues(&list, mSymbolDatabase, mErrorLogger, mSettings);
+        mAnalysis = ANALYSIS_VALUEFLOW;
+    }
 
     if (mSettings->terminated())
         return false;
@@ -111,7 +111,30 @@ public:
     bool createTokens(std::istream &code, const std::string& FileName);
     void createTokens(const simplecpp::TokenList *tokenList);
 
-    bool simplifyTokens1(const std::string &configuration);
+    /** Analysis of the normal token list. Each level includes the previous levels. */
+    enum Analysis {
+        ANALYSIS_AST,               ///< tokens, variable ids and AST
+        ANALYSIS_SYMBOLDATABASE,    ///< symbol database and value types
+        ANALYSIS_VALUEFLOW          ///< values of the tokens
+    };
+
+    /**
+     * Simplify the tokens into the normal form and analyse them.
+     * @param configuration E.g. "A" for code where "#ifdef A" is true
+     * @param analysis how far the token list is analysed, the rest can be
+     *   done later with analyse()
+     * @return false if source code contains syntax errors
+     */
+    bool simplifyTokens1(const std::string &configuration, Analysis analysis = ANALYSIS_VALUEFLOW);
+
+    /** Analyse the normal token list up to the given level, if that is not done yet */
+    void analyse(Analysis analysis);
+
+    /** How far the token list is analysed */
+    Analysis analysis() const {
+        return mAnalysis;
+    }
+
     /**
      * Tokenize code
      * @param code input stream for code, e.g.
@@ -885,6 +908,16 @@ private:
     /** Symbol database that all checks etc can use */
     SymbolDatabase *mSymbolDatabase;
 
+    /** How far the token list is analysed */
+    Analysis mAnalysis;
+
+    /**
+     * list.changes() after the symbol database was created. If the tokens
+     * are not changed after that, the AST, symbol database and values are
+     * still valid for them.
+     */
+    unsigned long long mAnalysisChanges;
+
     TemplateSimplifier *mTemplateSimplifier;
 
     /** E.g. "A" for code where "#ifdef A" is true. This is used to
@@ -28,8 +28,9 @@
 #include <simplecpp.h>
 #include <cctype>
 #include <cstring>
-#include <set>
+#include <map>
 #include <stack>
+#include <unordered_set>
 
 // How many compileExpression recursions are allowed?
 // For practical code this could be endless. But in some special torture test
@@ -356,6 +357,9 @@ unsigned long long TokenList::calculateChecksum() const
 
 //---------------------------------------------------------------------------
 
+// iscpp11init() results of the '{' tokens, shared by all statements of the token list
+typedef std::map<const Token *, bool> Cpp11InitCache;
+
 struct AST_state {
     std::stack<Token*> op;
     unsigned int depth;
@@ -363,7 +367,8 @@ struct AST_state {
     bool cpp;
     unsigned int assign;
     bool inCase; // true from case to :
-    explicit AST_state(bool cpp_) : depth(0), inArrayAssignment(0), cpp(cpp_), assign(0U), inCase(false) {}
+    Cpp11InitCache &cpp11init;
+    AST_state(bool cpp_, Cpp11InitCache &cpp11init_) : depth(0), inArrayAssignment(0), cpp(cpp_), assign(0U), inCase(false), cpp11init(cpp11init_) {}
 };
 
 static Token * skipDecl(Token *tok)
@@ -462,15 +467,9 @@ static Token * findCppTypeInitPar(Token *tok)
     return (tok && tok->str() == "(") ? tok : nullptr;
 }
 
-// X{} X<Y>{} etc
-static bool iscpp11init(const Token * const tok)
+// X{} X<Y>{} etc, nameToken is the X
+static bool iscpp11initName(const Token *nameToken)
 {
-    const Token *nameToken = tok;
-    while (nameToken && nameToken->str() == "{") {
-        nameToken = nameToken->previous();
-        if (nameToken && nameToken->str() == "," && Token::simpleMatch(nameToken->previous(), "} ,"))
-            nameToken = nameToken->linkAt(-1);
-    }
     if (!nameToken)
         return false;
     if (nameToken->str() == ">" && nameToken->link())
@@ -496,6 +495,34 @@ static bool iscpp11init(const Token * const tok)
     return true;
 }
 
+// X{} X<Y>{} etc
+static bool iscpp11init(const Token * const tok, Cpp11InitCache &cache)
+{
+    if (tok->str() != "{")
+        return iscpp11initName(tok);
+
+    const Cpp11InitCache::const_iterator it = cache.find(tok);
+    if (it != cache.end())
+        return it->second;
+
+    // Walk back over nested and preceding initializers to the name. Any
+    // '{' on the way has the same result, so the walk stops at the first
+    // known one. Otherwise every element of a long initializer list would
+    // walk back over all its preceding elements (#8355).
+    const Token *nameToken = tok;
+    while (nameToken && nameToken->str() == "{") {
+        if (nameToken != tok) {
+            const Cpp11InitCache::const_iterator it2 = cache.find(nameToken);
+            if (it2 != cache.end())
+                return cache[tok] = it2->second;
+        }
+        nameToken = nameToken->previous();
+        if (nameToken && nameToken->str() == "," && Token::simpleMatch(nameToken->previous(), "} ,"))
+            nameToken = nameToken->linkAt(-1);
+    }
+    return cache[tok] = iscpp11initName(nameToken);
+}
+
 static void compileUnaryOp(Token *&tok, AST_state& state, void(*f)(Token *&tok, AST_state& state))
 {
     Token *unaryop = tok;
@@ -579,7 +606,7 @@ static void compileTerm(Token *&tok, AST_state& state)
             tok = findCppTypeInitPar(tok);
             state.op.push(tok);
             tok = tok->tokAt(2);
-        } else if (state.cpp && iscpp11init(tok)) { // X{} X<Y>{} etc
+        } else if (state.cpp && iscpp11init(tok, state.cpp11init)) { // X{} X<Y>{} etc
             state.op.push(tok);
             tok = tok->next();
             if (tok->str() == "<")
@@ -605,7 +632,7 @@ static void compileTerm(Token *&tok, AST_state& state)
             prev = prev->link()->previous();
         if (Token::simpleMatch(tok->link(),"} [")) {
             tok = tok->next();
-        } else if (state.cpp && iscpp11init(tok)) {
+        } else if (state.cpp && iscpp11init(tok, state.cpp11init)) {
             if (state.op.empty() || Token::Match(tok->previous(), "[{,]"))
                 compileUnaryOp(tok, state, compileExpression);
             else
@@ -736,7 +763,7 @@ static void compilePrecedence2(Token *&tok, AST_state& state)
                     compileUnaryOp(tok, state, nullptr);
             }
             tok = tok->link()->next();
-        } else if (state.cpp && tok->str() == "{" && iscpp11init(tok)) {
+        } else if (state.cpp && tok->str() == "{" && iscpp11init(tok, state.cpp11init)) {
             if (Token::simpleMatch(tok, "{ }"))
                 compileUnaryOp(tok, state, compileExpression);
             else
@@ -1023,13 +1050,13 @@ static bool isLambdaCaptureList(const Token * tok)
     return true;
 }
 
-static Token * createAstAtToken(Token *tok, bool cpp);
+static Token * createAstAtToken(Token *tok, bool cpp, Cpp11InitCache &cpp11init);
 
 // Compile inner expressions inside inner ({..}) and lambda bodies
-static void createAstAtTokenInner(Token * const tok1, const Token *endToken, bool cpp)
+static void createAstAtTokenInner(Token * const tok1, const Token *endToken, bool cpp, Cpp11InitCache &cpp11init)
 {
     for (Token *tok = tok1; tok && tok != endToken; tok = tok ? tok->next() : nullptr) {
-        if (tok->str() == "{" && !iscpp11init(tok)) {
+        if (tok->str() == "{" && !iscpp11init(tok, cpp11init)) {
             if (Token::simpleMatch(tok->astOperand1(), ","))
                 continue;
             if (Token::simpleMatch(tok->previous(), "( {"))
@@ -1058,7 +1085,7 @@ static void createAstAtTokenInner(Token * const tok1, const Token *endToken, boo
 
             const Token * const endToken2 = tok->link();
             for (; tok && tok != endToken && tok != endToken2; tok = tok ? tok->next() : nullptr)
-                tok = createAstAtToken(tok, cpp);
+                tok = createAstAtToken(tok, cpp, cpp11init);
         } else if (tok->str() == "[") {
             if (isLambdaCaptureList(tok)) {
                 tok = const_cast<Token *>(tok->astOperand1());
@@ -1066,7 +1093,7 @@ static void createAstAtTokenInner(Token * const tok1, const Token *endToken, boo
                     tok = const_cast<Token *>(tok->astOperand1());
                 const Token * const endToken2 = tok->link();
                 for (; tok && tok != endToken && tok != endToken2; tok = tok ? tok->next() : nullptr)
-                    tok = createAstAtToken(tok, cpp);
+                    tok = createAstAtToken(tok, cpp, cpp11init);
             }
         }
     }
@@ -1089,7 +1116,7 @@ static Token * findAstTop(Token *tok1, Token *tok2)
     return nullptr;
 }
 
-static Token * createAstAtToken(Token *tok, bool cpp)
+static Token * createAstAtToken(Token *tok, bool cpp, Cpp11InitCache &cpp11init)
 {
     if (Token::simpleMatch(tok, "for (")) {
         Token *tok2 = skipDecl(tok->tokAt(2));
@@ -1102,7 +1129,7 @@ static Token * createAstAtToken(Token *tok, bool cpp)
                     break;
             } else if (Token::Match(tok2, "%name% %op%|(|[|.|:|::") || Token::Match(tok2->previous(), "[(;{}] %cop%|(")) {
                 init1 = tok2;
-                AST_state state1(cpp);
+                AST_state state1(cpp, cpp11init);
                 compileExpression(tok2, state1);
                 if (Token::Match(tok2, ";|)"))
                     break;
@@ -1124,14 +1151,14 @@ static Token * createAstAtToken(Token *tok, bool cpp)
 
         Token * const semicolon1 = tok2;
         tok2 = tok2->next();
-        AST_state state2(cpp);
+        AST_state state2(cpp, cpp11init);
         compileExpression(tok2, state2);
 
         Token * const semicolon2 = tok2;
         if (!semicolon2)
             return nullptr; // invalid code #7235
         tok2 = tok2->next();
-        AST_state state3(cpp);
+        AST_state state3(cpp, cpp11init);
         if (Token::simpleMatch(tok2, "( {")) {
             state3.op.push(tok2->next());
             tok2 = tok2->link()->next();
@@ -1153,7 +1180,7 @@ static Token * createAstAtToken(Token *tok, bool cpp)
         tok->next()->astOperand1(tok);
         tok->next()->astOperand2(semicolon1);
 
-        createAstAtTokenInner(endPar->link(), endPar, cpp);
+        createAstAtTokenInner(endPar->link(), endPar, cpp, cpp11init);
 
         return endPar;
     }
@@ -1169,13 +1196,13 @@ static Token * createAstAtToken(Token *tok, bool cpp)
             tok = tok->previous();
 
         Token * const tok1 = tok;
-        AST_state state(cpp);
+        AST_state state(cpp, cpp11init);
         compileExpression(tok, state);
         const Token * const endToken = tok;
         if (endToken == tok1 || !endToken)
             return tok1;
 
-        createAstAtTokenInner(tok1->next(), endToken, cpp);
+        createAstAtTokenInner(tok1->next(), endToken, cpp, cpp11init);
 
         return endToken->previous();
     }
@@ -1185,18 +1212,19 @@ static Token * createAstAtToken(Token *tok, bool cpp)
 
 void TokenList::createAst()
 {
+    Cpp11InitCache cpp11init;
     for (Token *tok = mTokensFrontBack.front; tok; tok = tok ? tok->next() : nullptr) {
-        tok = createAstAtToken(tok, isCPP());
+        tok = createAstAtToken(tok, isCPP(), cpp11init);
     }
 }
 
 void TokenList::validateAst() const
 {
     // Check for some known issues in AST to avoid crash/hang later on
-    std::set < const Token* > safeAstTokens; // list of "safe" AST tokens without endless recursion
+    std::unordered_set < const Token* > safeAstTokens; // list of "safe" AST tokens without endless recursion
     for (const Token *tok = mTokensFrontBack.front; tok; tok = tok->next()) {
         // Syntax error if binary operator only has 1 operand
-        if ((tok->isAssignmentOp() || tok->isComparisonOp() || Token::Match(tok,"[|^/%]")) && tok->astOperand1() && !tok->astOperand2())
+        if (tok->astOperand1() && !tok->astOperand2() && (tok->isAssignmentOp() || tok->isComparisonOp() || Token::Match(tok,"[|^/%]")))
             throw InternalError(tok, "Syntax Error: AST broken, binary operator has only one operand.", InternalError::AST);
 
         // Syntax error if we encounter "?" with operand2 that is not ":"
@@ -1206,24 +1234,33 @@ void TokenList::validateAst() const
         // Check for endless recursion
         const Token* parent = tok->astParent();
         if (parent) {
-            std::set < const Token* > astTokens; // list of anchestors
-            astTokens.insert(tok);
+            // Brent's cycle detection on the ancestors, until a safe one is reached
+            const Token *power = tok;
+            unsigned int steps = 0U, maxSteps = 1U;
             do {
                 if (safeAstTokens.find(parent) != safeAstTokens.end())
                     break;
-                if (astTokens.find(parent) != astTokens.end())
+                if (parent == power)
                     throw InternalError(tok, "AST broken: endless recursion from '" + tok->str() + "'", InternalError::AST);
-                astTokens.insert(parent);
+                if (++steps == maxSteps) {
+                    power = parent;
+                    steps = 0U;
+                    maxSteps *= 2U;
+                }
             } while ((parent = parent->astParent()) != nullptr);
-            safeAstTokens.insert(astTokens.begin(), astTokens.end());
+            for (const Token *ancestor = tok; ancestor != parent; ancestor = ancestor->astParent())
+                safeAstTokens.insert(ancestor);
         } else if (tok->str() == ";") {
-            safeAstTokens.clear();
+            // Start over with a small set, clear() would be slow after a huge statement
+            std::unordered_set < const Token* >().swap(safeAstTokens);
         } else {
             safeAstTokens.insert(tok);
         }
 
         // Check binary operators
-        if (Token::Match(tok, "%or%|%oror%|%assign%|%comp%")) {
+        if (tok->isAssignmentOp() || tok->isComparisonOp() ||
+            (tok->tokType() == Token::eBitOp && tok->str() == "|") ||
+            (tok->tokType() == Token::eLogicalOp && tok->str() == "||")) {
             // Skip lambda captures
             if (Token::Match(tok, "= ,|]"))
                 continue;
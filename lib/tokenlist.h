@@ -119,6 +119,14 @@ public:
         return mTokensFrontBack.back;
     }
 
+    /**
+     * Number of changes of the tokens so far. If it is the same before
+     * and after some code, that code did not change the token list.
+     */
+    unsigned long long changes() const {
+        return mTokensFrontBack.changes;
+    }
+
     /**
      * Get filenames (the sourcefile + the files it include).
      * The first filename is the filename for the sourcefile
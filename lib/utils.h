@@ -24,6 +24,7 @@
 #include <algorithm>
 #include <cctype>
 #include <cstddef>
+#include <cstdint>
 #include <string>
 
 inline bool endsWith(const std::string &str, char c)
@@ -36,6 +37,23 @@ inline bool endsWith(const std::string &str, const char end[], std::size_t endle
     return (str.size() >= endlen) && (str.compare(str.size()-endlen, endlen, end)==0);
 }
 
+/** Update a 64-bit FNV-1a hash with the given data */
+inline void fnv1a64(std::uint64_t &hash, const std::string &data)
+{
+    for (std::string::const_iterator c = data.begin(); c != data.end(); ++c) {
+        hash ^= (unsigned char)(*c);
+        hash *= 0x100000001b3ULL;
+    }
+}
+
+/** 64-bit FNV-1a hash of the given data */
+inline std::uint64_t fnv1a64(const std::string &data)
+{
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    fnv1a64(hash, data);
+    return hash;
+}
+
 inline static const char *getOrdinalText(int i)
 {
     if (i == 1)
@@ -479,7 +479,7 @@ static void setTokenValue(Token* tok, const ValueFlow::Value &value, const Setti
                 const Token *op = cond ? tok->astOperand1() : tok->astOperand2();
                 if (!op) // #7769 segmentation fault at setTokenValue()
                     return;
-                const std::list<ValueFlow::Value> &values = op->values();
+                const std::vector<ValueFlow::Value> &values = op->values();
                 if (std::find(values.begin(), values.end(), value) != values.end())
                     setTokenValue(parent, value, settings);
             }
@@ -1171,7 +1171,9 @@ static void valueFlowSameExpressions(TokenList *tokenlist)
         if (!val.isKnown())
             continue;
 
-        if (isSameExpression(tokenlist->isCPP(), false, tok->astOperand1(), tok->astOperand2(), tokenlist->getSettings()->library, true, true, &val.errorPath)) {
+        ErrorPath errorPath;
+        if (isSameExpression(tokenlist->isCPP(), false, tok->astOperand1(), tok->astOperand2(), tokenlist->getSettings()->library, true, true, &errorPath)) {
+            val.errorPath = errorPath;
             setTokenValue(tok, val, tokenlist->getSettings());
         }
     }
@@ -1809,7 +1811,7 @@ static void valueFlowAST(Token *tok, unsigned int varid, const ValueFlow::Value
         if (conditionIsFalse(tok->astOperand1(), pm))
             return;
     } else if (tok->str() == "||" && tok->astOperand1()) {
-        const std::list<ValueFlow::Value> &values = tok->astOperand1()->values();
+        const std::vector<ValueFlow::Value> &values = tok->astOperand1()->values();
         bool nonzero = false;
         for (const ValueFlow::Value &v : values) {
             if (v.intvalue != 0) {
@@ -2614,7 +2616,7 @@ static void valueFlowForwardLifetime(Token * tok, TokenList *tokenlist, ErrorLog
             !(var->valueType() && var->valueType()->isIntegral()))
             return;
 
-        std::list<ValueFlow::Value> values = parent->astOperand2()->values();
+        std::list<ValueFlow::Value> values(parent->astOperand2()->values().begin(), parent->astOperand2()->values().end());
 
         // Static variable initialisation?
         if (var->isStatic() && var->nameToken() == parent->astOperand1())
@@ -2645,7 +2647,7 @@ static void valueFlowForwardLifetime(Token * tok, TokenList *tokenlist, ErrorLog
             return;
         const Token *endOfVarScope = var->typeStartToken()->scope()->bodyEnd;
 
-        std::list<ValueFlow::Value> values = tok->values();
+        std::list<ValueFlow::Value> values(tok->values().begin(), tok->values().end());
         const Token *nextExpression = nextAfterAstRightmostLeaf(parent);
         // Only forward lifetime values
         values.remove_if(&isNotLifetimeValue);
@@ -3131,7 +3133,7 @@ static void valueFlowAfterAssign(TokenList *tokenlist, SymbolDatabase* symboldat
             if (!tok->astOperand2() || tok->astOperand2()->values().empty())
                 continue;
 
-            std::list<ValueFlow::Value> values = tok->astOperand2()->values();
+            std::list<ValueFlow::Value> values(tok->astOperand2()->values().begin(), tok->astOperand2()->values().end());
             if (std::any_of(values.begin(), values.end(), std::mem_fn(&ValueFlow::Value::isLifetimeValue))) {
                 valueFlowForwardLifetime(tok, tokenlist, errorLogger, settings);
                 values.remove_if(std::mem_fn(&ValueFlow::Value::isLifetimeValue));
@@ -4107,7 +4109,7 @@ static bool evaluate(const Token *expr, const std::vector<std::list<ValueFlow::V
 
 static std::list<ValueFlow::Value> getFunctionArgumentValues(const Token *argtok)
 {
-    std::list<ValueFlow::Value> argvalues(argtok->values());
+    std::list<ValueFlow::Value> argvalues(argtok->values().begin(), argtok->values().end());
     if (argvalues.empty() && Token::Match(argtok, "%comp%|%oror%|&&|!")) {
         argvalues.emplace_back(0);
         argvalues.emplace_back(1);
@@ -4232,7 +4234,7 @@ static void valueFlowFunctionDefaultParameter(TokenList *tokenlist, SymbolDataba
         for (std::size_t arg = function->minArgCount(); arg < function->argCount(); arg++) {
             const Variable* var = function->getArgumentVar(arg);
             if (var && var->hasDefault() && Token::Match(var->nameToken(), "%var% = %num%|%str% [,)]")) {
-                const std::list<ValueFlow::Value> &values = var->nameToken()->tokAt(2)->values();
+                const std::vector<ValueFlow::Value> &values = var->nameToken()->tokAt(2)->values();
                 std::list<ValueFlow::Value> argvalues;
                 for (const ValueFlow::Value &value : values) {
                     ValueFlow::Value v(value);
@@ -4715,12 +4717,18 @@ static void valueFlowFwdAnalysis(const TokenList *tokenlist, const Settings *set
     }
 }
 
+const ValueFlow::Value::ErrorPath &ValueFlow::Value::SharedErrorPath::emptyPath()
+{
+    static const ErrorPath empty;
+    return empty;
+}
+
 ValueFlow::Value::Value(const Token *c, long long val)
     : valueType(INT),
+      moveKind(NonMovedVariable),
       intvalue(val),
       tokvalue(nullptr),
       floatValue(0.0),
-      moveKind(NonMovedVariable),
       varvalue(val),
       condition(c),
       varId(0U),
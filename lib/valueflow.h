@@ -23,7 +23,9 @@
 
 #include "config.h"
 
+#include <cstddef>
 #include <list>
+#include <memory>
 #include <string>
 #include <utility>
 
@@ -39,7 +41,58 @@ namespace ValueFlow {
         typedef std::pair<const Token *, std::string> ErrorPathItem;
         typedef std::list<ErrorPathItem> ErrorPath;
 
-        explicit Value(long long val = 0) : valueType(INT), intvalue(val), tokvalue(nullptr), floatValue(0.0), moveKind(NonMovedVariable), varvalue(val), condition(nullptr), varId(0U), conditional(false), defaultArg(false), lifetimeKind(Object), valueKind(ValueKind::Possible) {}
+        /**
+         * Error path of a value. Values are copied very often while they are
+         * forwarded, so the path is shared between the copies and it is only
+         * copied when a shared path is modified.
+         */
+        class CPPCHECKLIB SharedErrorPath {
+        public:
+            SharedErrorPath() {}
+            explicit SharedErrorPath(const ErrorPath &errorPath) {
+                *this = errorPath;
+            }
+
+            SharedErrorPath &operator=(const ErrorPath &errorPath) {
+                if (errorPath.empty())
+                    mPath.reset();
+                else
+                    mPath = std::make_shared<ErrorPath>(errorPath);
+                return *this;
+            }
+
+            operator const ErrorPath &() const {
+                return mPath ? *mPath : emptyPath();
+            }
+
+            bool empty() const {
+                return !mPath || mPath->empty();
+            }
+            std::size_t size() const {
+                return mPath ? mPath->size() : 0;
+            }
+            ErrorPath::const_iterator begin() const {
+                return static_cast<const ErrorPath &>(*this).begin();
+            }
+            ErrorPath::const_iterator end() const {
+                return static_cast<const ErrorPath &>(*this).end();
+            }
+
+            void emplace_back(const Token *tok, const std::string &info) {
+                if (!mPath)
+                    mPath = std::make_shared<ErrorPath>();
+                else if (mPath.use_count() > 1)
+                    mPath = std::make_shared<ErrorPath>(*mPath);
+                mPath->emplace_back(tok, info);
+            }
+
+        private:
+            static const ErrorPath &emptyPath();
+
+            std::shared_ptr<ErrorPath> mPath;
+        };
+
+        explicit Value(long long val = 0) : valueType(INT), moveKind(NonMovedVariable), intvalue(val), tokvalue(nullptr), floatValue(0.0), varvalue(val), condition(nullptr), varId(0U), conditional(false), defaultArg(false), lifetimeKind(Object), valueKind(ValueKind::Possible) {}
         Value(const Token *c, long long val);
 
         bool operator==(const Value &rhs) const {
@@ -85,6 +138,10 @@ namespace ValueFlow {
         std::string infoString() const;
 
         enum ValueType { INT, TOK, FLOAT, MOVED, UNINIT, CONTAINER_SIZE, LIFETIME } valueType;
+
+        /** kind of moved  */
+        enum MoveKind {NonMovedVariable, MovedVariable, ForwardedVariable} moveKind;
+
         bool isIntValue() const {
             return valueType == INT;
         }
@@ -116,16 +173,13 @@ namespace ValueFlow {
         /** float value */
         double floatValue;
 
-        /** kind of moved  */
-        enum MoveKind {NonMovedVariable, MovedVariable, ForwardedVariable} moveKind;
-
         /** For calculated values - variable value that calculated value depends on */
         long long varvalue;
 
         /** Condition that this value depends on */
         const Token *condition;
 
-        ErrorPath errorPath;
+        SharedErrorPath errorPath;
 
         /** For calculated values - varId that calculated value depends on */
         unsigned int varId;
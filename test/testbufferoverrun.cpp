@@ -627,6 +627,24 @@ private:
               "}");
         ASSERT_EQUALS("[test.cpp:9] -> [test.cpp:3]: (error) Array 'str[5]' accessed at index 10, which is out of bounds.\n", errout.str());
 
+        // same function called with several arrays
+        check("static void memclr( char *data )\n"
+              "{\n"
+              "    data[10] = 0;\n"
+              "}\n"
+              "\n"
+              "static void f()\n"
+              "{\n"
+              "    char str1[5];\n"
+              "    char str2[20];\n"
+              "    char str3[8];\n"
+              "    memclr( str1 );\n"
+              "    memclr( str2 );\n"
+              "    memclr( str3 );\n"
+              "}");
+        ASSERT_EQUALS("[test.cpp:11] -> [test.cpp:3]: (error) Array 'str1[5]' accessed at index 10, which is out of bounds.\n"
+                      "[test.cpp:13] -> [test.cpp:3]: (error) Array 'str3[8]' accessed at index 10, which is out of bounds.\n", errout.str());
+
         check("static void memclr( int i, char *data )\n"
               "{\n"
               "    data[i] = 0;\n"
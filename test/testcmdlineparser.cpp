@@ -103,6 +103,14 @@ private:
         TEST_CASE(maxConfigsInvalid);
         TEST_CASE(maxConfigsTooSmall);
         TEST_CASE(reportProgressTest); // "Test" suffix to avoid hiding the parent's reportProgress
+        TEST_CASE(shard);
+        TEST_CASE(shardInvalid);
+        TEST_CASE(shardOutOfRange);
+        TEST_CASE(shardWithoutBuildDir);
+        TEST_CASE(isInShard);
+        TEST_CASE(mergeBuildDir);
+        TEST_CASE(mergeBuildDirEmpty);
+        TEST_CASE(mergeBuildDirMissing);
         TEST_CASE(stdposix);
         TEST_CASE(stdc99);
         TEST_CASE(stdcpp11);
@@ -126,6 +134,8 @@ private:
         TEST_CASE(xmlverinvalid);
         TEST_CASE(doc);
         TEST_CASE(showtime);
+        TEST_CASE(showmemory);
+        TEST_CASE(showmemoryInvalid);
         TEST_CASE(errorlist1);
         TEST_CASE(errorlistverbose1);
         TEST_CASE(errorlistverbose2);
@@ -694,6 +704,97 @@ private:
         ASSERT(settings.reportProgress);
     }
 
+    void shard() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--shard=2/3", "--cppcheck-build-dir=shard2", "file.cpp"};
+        CmdLineParser parser(&settings);
+        ASSERT(parser.parseFromArgs(4, argv));
+        ASSERT_EQUALS(2, parser.getShardIndex());
+        ASSERT_EQUALS(3, parser.getShardCount());
+        settings.buildDir.clear();
+    }
+
+    void shardInvalid() {
+        REDIRECT;
+        const char * const argv1[] = {"cppcheck", "--shard=2", "file.cpp"};
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv1));
+        const char * const argv2[] = {"cppcheck", "--shard=2-3", "file.cpp"};
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv2));
+        const char * const argv3[] = {"cppcheck", "--shard=2/3x", "file.cpp"};
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv3));
+    }
+
+    void shardOutOfRange() {
+        REDIRECT;
+        const char * const argv1[] = {"cppcheck", "--shard=0/3", "file.cpp"};
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv1));
+        const char * const argv2[] = {"cppcheck", "--shard=4/3", "file.cpp"};
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv2));
+    }
+
+    void shardWithoutBuildDir() {
+        REDIRECT;
+        // The whole program analysis results would be lost
+        const char * const argv1[] = {"cppcheck", "--shard=2/3", "file.cpp"};
+        CmdLineParser parser1(&settings);
+        ASSERT_EQUALS(false, parser1.parseFromArgs(3, argv1));
+        ASSERT_EQUALS("cppcheck: '--shard' requires '--cppcheck-build-dir', the whole program analysis is done when the build dirs are merged with '--merge-build-dir'.\n", GET_REDIRECT_OUTPUT);
+        // A single shard checks all files
+        const char * const argv2[] = {"cppcheck", "--shard=1/1", "file.cpp"};
+        CmdLineParser parser2(&settings);
+        ASSERT(parser2.parseFromArgs(3, argv2));
+    }
+
+    void isInShard() const {
+        const char * const files[] = {"lib/token.cpp", "lib/tokenize.cpp", "cli/main.cpp", "test/testrunner.cpp", "a.c"};
+        // Every file is in exactly one shard
+        for (unsigned int count = 1; count <= 5; ++count) {
+            for (const char *file : files) {
+                unsigned int shards = 0;
+                for (unsigned int index = 1; index <= count; ++index) {
+                    if (CmdLineParser::isInShard(file, index, count))
+                        ++shards;
+                }
+                ASSERT_EQUALS(1U, shards);
+            }
+        }
+        // The split only depends on the path, so it is the same in every run
+        ASSERT_EQUALS(true, CmdLineParser::isInShard("lib/token.cpp", 1, 3));
+        ASSERT_EQUALS(true, CmdLineParser::isInShard("lib/tokenize.cpp", 2, 3));
+        ASSERT_EQUALS(true, CmdLineParser::isInShard("cli/main.cpp", 1, 4));
+        ASSERT_EQUALS(true, CmdLineParser::isInShard("test/testrunner.cpp", 4, 4));
+        ASSERT_EQUALS(true, CmdLineParser::isInShard("a.c", 2, 2));
+        // Native separators give the same shard
+        ASSERT_EQUALS(true, CmdLineParser::isInShard("test\\testrunner.cpp", 4, 4));
+    }
+
+    void mergeBuildDir() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--merge-build-dir=.", "--merge-build-dir=../"};
+        CmdLineParser parser(&settings);
+        ASSERT(parser.parseFromArgs(3, argv));
+        ASSERT_EQUALS(2U, parser.getMergeBuildDirs().size());
+        ASSERT_EQUALS(".", parser.getMergeBuildDirs()[0]);
+        ASSERT_EQUALS("..", parser.getMergeBuildDirs()[1]);
+    }
+
+    void mergeBuildDirEmpty() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--merge-build-dir=", "file.cpp"};
+        CmdLineParser parser(&settings);
+        ASSERT_EQUALS(false, parser.parseFromArgs(3, argv));
+        ASSERT_EQUALS("cppcheck: No directory given to '--merge-build-dir' option.\n", GET_REDIRECT_OUTPUT);
+    }
+
+    void mergeBuildDirMissing() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--merge-build-dir=shard-missing", "file.cpp"};
+        CmdLineParser parser(&settings);
+        ASSERT_EQUALS(false, parser.parseFromArgs(3, argv));
+        ASSERT_EQUALS("cppcheck: Directory 'shard-missing' specified by --merge-build-dir argument has to be existent.\n", GET_REDIRECT_OUTPUT);
+        ASSERT_EQUALS(0U, parser.getMergeBuildDirs().size());
+    }
+
     void stdposix() {
         REDIRECT;
         const char * const argv[] = {"cppcheck", "--std=posix", "file.cpp"};
@@ -907,6 +1008,21 @@ private:
         ASSERT(settings.showtime == SHOWTIME_SUMMARY);
     }
 
+    void showmemory() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--showmemory=file", "file.cpp"};
+        settings.showmemory = SHOWTIME_NONE;
+        ASSERT(defParser.parseFromArgs(3, argv));
+        ASSERT(settings.showmemory == SHOWTIME_FILE);
+        settings.showmemory = SHOWTIME_NONE;
+    }
+
+    void showmemoryInvalid() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--showmemory=all", "file.cpp"};
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
+    }
+
     void errorlist1() {
         REDIRECT;
         const char * const argv[] = {"cppcheck", "--errorlist"};
@@ -58,6 +58,7 @@ private:
         TEST_CASE(comparison);         // CheckCondition::comparison test cases
         TEST_CASE(multicompare);       // mismatching comparisons
         TEST_CASE(duplicateIf);        // duplicate conditions in if and else-if
+        TEST_CASE(duplicateIfChain);   // equivalent conditions in an else-if chain
 
         TEST_CASE(checkBadBitmaskCheck);
 
@@ -512,6 +513,66 @@ private:
         checkCondition.runSimplifiedChecks(&tokenizer, &settings1, this);
     }
 
+    void duplicateIfChain() {
+        // Mirrored comparisons
+        check("void f(int a, int b) {\n"
+              "    if (a < b) {}\n"
+              "    else if (a == 0) {}\n"
+              "    else if (b > a) {}\n"
+              "}");
+        ASSERT_EQUALS("[test.cpp:4]: (style) Expression is always false because 'else if' condition matches previous condition at line 2.\n", errout.str());
+
+        check("void f(int a, int b) {\n"
+              "    if (a <= b) {}\n"
+              "    else if (a == 0) {}\n"
+              "    else if (b >= a) {}\n"
+              "}");
+        ASSERT_EQUALS("[test.cpp:4]: (style) Expression is always false because 'else if' condition matches previous condition at line 2.\n", errout.str());
+
+        check("void f(int a, int b) {\n"
+              "    if (a < b) {}\n"
+              "    else if (a > b) {}\n"
+              "}");
+        ASSERT_EQUALS("", errout.str());
+
+        // Swapped operands
+        check("void f(int x) {\n"
+              "    if (1 == x) {}\n"
+              "    else if (x == 2) {}\n"
+              "    else if (x == 1) {}\n"
+              "}");
+        ASSERT_EQUALS("[test.cpp:4]: (style) Expression is always false because 'else if' condition matches previous condition at line 2.\n", errout.str());
+
+        // Member with and without 'this->'
+        check("struct A {\n"
+              "    int x;\n"
+              "    void f() {\n"
+              "        if (this->x == 1) {}\n"
+              "        else if (x == 2) {}\n"
+              "        else if (x == 1) {}\n"
+              "    }\n"
+              "};");
+        ASSERT_EQUALS("[test.cpp:6]: (style) Expression is always false because 'else if' condition matches previous condition at line 4.\n", errout.str());
+
+        // Bitmask and comparison with the number first
+        check("void f(int x) {\n"
+              "    if (7 & x) {}\n"
+              "    else if (x == 8) {}\n"
+              "    else if (x == 1) {}\n"
+              "}");
+        ASSERT_EQUALS("[test.cpp:4]: (style) Expression is always false because 'else if' condition matches previous condition at line 2.\n", errout.str());
+
+        // Long chain, the duplicate is far from its original
+        std::string code = "void f(int x, int y) {\n"
+                           "    if (x == 0 && y) {}\n";
+        for (int i = 1; i < 100; ++i)
+            code += "    else if (x == " + std::to_string(i) + ") {}\n";
+        code += "    else if (y && x == 0) {}\n"
+                "}";
+        check(code.c_str());
+        ASSERT_EQUALS("[test.cpp:102]: (style) Expression is always false because 'else if' condition matches previous condition at line 2.\n", errout.str());
+    }
+
     void duplicateIf() {
         check("void f(int a, int &b) {\n"
               "    if (a) { b = 1; }\n"
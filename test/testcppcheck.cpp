@@ -16,14 +16,26 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "analyzerinfo.h"
 #include "check.h"
 #include "cppcheck.h"
 #include "errorlogger.h"
+#include "settings.h"
 #include "testsuite.h"
 
 #include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <list>
 #include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 
 class TestCppcheck : public TestFixture {
@@ -49,6 +61,37 @@ private:
         TEST_CASE(instancesSorted);
         TEST_CASE(classInfoFormat);
         TEST_CASE(getErrorMessages);
+        TEST_CASE(hasSimplifiedChecks);
+        TEST_CASE(compileRules);
+        TEST_CASE(mergeBuildDirs);
+    }
+
+    class ErrorLogger3 : public ErrorLogger {
+    public:
+        std::list<std::string> errmsg;
+
+        void reportOut(const std::string & /*outmsg*/) override {
+        }
+
+        void reportErr(const ErrorLogger::ErrorMessage &msg) override {
+            errmsg.push_back(msg.toString(false));
+        }
+    };
+
+    static void makeDir(const std::string &path) {
+#ifdef _WIN32
+        _mkdir(path.c_str());
+#else
+        mkdir(path.c_str(), 0755);
+#endif
+    }
+
+    static void removeDir(const std::string &path) {
+#ifdef _WIN32
+        _rmdir(path.c_str());
+#else
+        rmdir(path.c_str());
+#endif
     }
 
     void instancesSorted() const {
@@ -105,6 +148,113 @@ private:
         ASSERT(foundPurgedConfiguration);
         ASSERT(foundTooManyConfigs);
     }
+
+    void hasSimplifiedChecks() const {
+        // Checks that never, or only when enabled, use the simplified token list
+        std::list<Check *> checks;
+        for (Check *check : Check::instances()) {
+            if (check->name() == "Assert" || check->name() == "64-bit portability" || check->name() == "Type")
+                checks.push_back(check);
+        }
+        ASSERT_EQUALS(3U, checks.size());
+
+        {
+            // No check, rule or debug output uses it => the pass is skipped
+            Settings settings;
+            ASSERT_EQUALS(false, CppCheck::hasSimplifiedChecks(settings, checks));
+            ASSERT_EQUALS(false, CppCheck::hasSimplifiedChecks(settings, std::list<Check *>()));
+        }
+        {
+            Settings settings;
+            settings.addEnabled("warning");
+            ASSERT_EQUALS(true, CppCheck::hasSimplifiedChecks(settings, checks));
+        }
+        {
+            Settings settings;
+            Settings::Rule rule;
+            rule.tokenlist = "normal";
+            settings.rules.push_back(rule);
+            ASSERT_EQUALS(false, CppCheck::hasSimplifiedChecks(settings, checks));
+            rule.tokenlist = "simple";
+            settings.rules.push_back(rule);
+            ASSERT_EQUALS(true, CppCheck::hasSimplifiedChecks(settings, checks));
+        }
+        {
+            Settings settings;
+            settings.debugnormal = true;
+            ASSERT_EQUALS(false, CppCheck::hasSimplifiedChecks(settings, checks));
+            settings.debugSimplified = true;
+            ASSERT_EQUALS(true, CppCheck::hasSimplifiedChecks(settings, checks));
+        }
+        {
+            Settings settings;
+            settings.debugwarnings = true;
+            ASSERT_EQUALS(true, CppCheck::hasSimplifiedChecks(settings, checks));
+        }
+        {
+            // Several checks still use the simplified token list
+            Settings settings;
+            ASSERT_EQUALS(true, CppCheck::hasSimplifiedChecks(settings));
+        }
+    }
+
+    void compileRules() const {
+        ErrorLogger2 errorLogger;
+        CppCheck cppCheck(errorLogger, true);
+        Settings::Rule rule;
+        rule.pattern = "abc";
+        cppCheck.settings().rules.push_back(rule);
+        ASSERT(cppCheck.settings().rulePatterns == nullptr);
+        cppCheck.compileRules();
+        ASSERT(cppCheck.settings().rulePatterns != nullptr);
+
+        // The copies for the files and workers share the compiled patterns
+        const Settings copy = cppCheck.settings();
+        ASSERT(copy.rulePatterns == cppCheck.settings().rulePatterns);
+    }
+
+    void mergeBuildDirs() {
+        // Each file is checked in its own shard, the header in both
+        std::ofstream("merge.h") << "int h(void) { int a[2]; a[2] = 0; return a[0]; }\n";
+        std::ofstream("merge1.c") << "#include \"merge.h\"\nvoid used(void) {}\nvoid unused1(void) { h(); }\n";
+        std::ofstream("merge2.c") << "#include \"merge.h\"\nvoid used(void);\nvoid unused2(void) { used(); h(); }\n";
+        const std::vector<std::string> buildDirs = {"merge-shard1", "merge-shard2"};
+        const std::string files[] = {"merge1.c", "merge2.c"};
+        for (int i = 0; i < 2; ++i) {
+            makeDir(buildDirs[i]);
+            AnalyzerInformation::writeFilesTxt(buildDirs[i], std::list<std::string>(1, files[i]), std::list<ImportProject::FileSettings>());
+            ErrorLogger3 errorLogger;
+            CppCheck cppCheck(errorLogger, true);
+            cppCheck.settings().buildDir = buildDirs[i];
+            cppCheck.settings().addEnabled("style");
+            cppCheck.settings().addEnabled("unusedFunction");
+            cppCheck.check(files[i]);
+            ASSERT_EQUALS(1U, errorLogger.errmsg.size());
+        }
+
+        ErrorLogger3 errorLogger;
+        CppCheck cppCheck(errorLogger, true);
+        cppCheck.settings().addEnabled("style");
+        cppCheck.settings().addEnabled("unusedFunction");
+        ASSERT_EQUALS(1U, cppCheck.mergeBuildDirs(buildDirs));
+        errorLogger.errmsg.sort();
+        const std::string expected[] = {
+            "[merge.h:1]: (error) Array 'a[2]' accessed at index 2, which is out of bounds.",
+            "[merge1.c:3]: (style) The function 'unused1' is never used.",
+            "[merge2.c:3]: (style) The function 'unused2' is never used."
+        };
+        ASSERT_EQUALS(3U, errorLogger.errmsg.size());
+        ASSERT(std::equal(errorLogger.errmsg.begin(), errorLogger.errmsg.end(), expected));
+
+        for (int i = 0; i < 2; ++i) {
+            std::remove((buildDirs[i] + "/files.txt").c_str());
+            std::remove((buildDirs[i] + "/merge" + std::to_string(i + 1) + ".a1").c_str());
+            removeDir(buildDirs[i]);
+        }
+        std::remove("merge1.c");
+        std::remove("merge2.c");
+        std::remove("merge.h");
+    }
 };
 
 REGISTER_TEST(TestCppcheck)
@@ -21,6 +21,7 @@
 #include "errorlogger.h"
 #include "suppressions.h"
 #include "testsuite.h"
+#include "utils.h"
 
 #include <list>
 #include <string>
@@ -49,6 +50,8 @@ private:
         TEST_CASE(ToXmlV2);
         TEST_CASE(ToXmlV2Locations);
         TEST_CASE(ToXmlV2Encoding);
+        TEST_CASE(ToSarif);
+        TEST_CASE(ToSarifLocations);
 
         // Inconclusive results in xml reports..
         TEST_CASE(InconclusiveXml);
@@ -230,6 +233,32 @@ private:
         }
     }
 
+    void ToSarif() const {
+        std::list<ErrorLogger::ErrorMessage::FileLocation> locs(1, fooCpp5);
+        ErrorMessage msg(locs, emptyString, Severity::style, "Comparing \"a\" with \"b\".\nVerbose error", "errorId", CWE(570U), true);
+        ASSERT_EQUALS("{\"ruleId\":\"errorId\",\"level\":\"note\",\"message\":{\"text\":\"Comparing \\\"a\\\" with \\\"b\\\".\"},"
+                      "\"locations\":[{\"physicalLocation\":{\"artifactLocation\":{\"uri\":\"foo.cpp\"},\"region\":{\"startLine\":5}}}],"
+                      "\"properties\":{\"severity\":\"style\",\"cwe\":570,\"inconclusive\":true}}",
+                      msg.toSarif());
+
+        const std::string header = ErrorLogger::ErrorMessage::getSarifHeader();
+        ASSERT(header.find("\"version\": \"2.1.0\"") != std::string::npos);
+        ASSERT(endsWith(header, "\"results\": [", 12));
+        ASSERT_EQUALS("      ]\n    }\n  ]\n}", ErrorLogger::ErrorMessage::getSarifFooter());
+    }
+
+    void ToSarifLocations() const {
+        std::list<ErrorLogger::ErrorMessage::FileLocation> locs = { fooCpp5, barCpp8 };
+        locs.front().setinfo("tab\there");
+        ErrorMessage msg(locs, emptyString, Severity::error, "Programming error.", "errorId", false);
+        ASSERT_EQUALS("{\"ruleId\":\"errorId\",\"level\":\"error\",\"message\":{\"text\":\"Programming error.\"},"
+                      "\"locations\":[{\"physicalLocation\":{\"artifactLocation\":{\"uri\":\"bar.cpp\"},\"region\":{\"startLine\":8}}}],"
+                      "\"relatedLocations\":[{\"message\":{\"text\":\"tab\\there\"},\"physicalLocation\":{\"artifactLocation\":{\"uri\":\"foo.cpp\"},\"region\":{\"startLine\":5}}},"
+                      "{\"physicalLocation\":{\"artifactLocation\":{\"uri\":\"bar.cpp\"},\"region\":{\"startLine\":8}}}],"
+                      "\"properties\":{\"severity\":\"error\"}}",
+                      msg.toSarif());
+    }
+
     void InconclusiveXml() const {
         // Location
         std::list<ErrorLogger::ErrorMessage::FileLocation> locs(1, fooCpp5);
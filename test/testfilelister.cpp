@@ -47,6 +47,7 @@ private:
 
         TEST_CASE(isDirectory);
         TEST_CASE(recursiveAddFiles);
+        TEST_CASE(recursiveAddFilesIgnored);
     }
 
     void isDirectory() const {
@@ -79,6 +80,22 @@ private:
         // Make sure headers are not added..
         ASSERT(files.find("lib/tokenize.h") == files.end());
     }
+
+    void recursiveAddFilesIgnored() const {
+        std::map<std::string, std::size_t> files;
+        const std::vector<std::string> masks = { "lib/", "main.cpp" };
+        PathMatch matcher(masks);
+        FileLister::recursiveAddFiles(files, "cli", matcher);
+
+        ASSERT(files.find("cli/main.cpp") == files.end());
+        ASSERT(files.find("cli/filelister.cpp") != files.end());
+        ASSERT(files.find("cli/filelister.cpp")->second > 0);
+
+        files.clear();
+        FileLister::recursiveAddFiles(files, ".", matcher);
+        for (std::map<std::string, std::size_t>::const_iterator i = files.begin(); i != files.end(); ++i)
+            ASSERT(i->first.find("lib/") == std::string::npos);
+    }
 };
 
 REGISTER_TEST(TestFileLister)
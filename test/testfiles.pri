@@ -39,6 +39,7 @@ SOURCES += $${BASEPATH}/test64bit.cpp \
            $${BASEPATH}/testpreprocessor.cpp \
            $${BASEPATH}/testrunner.cpp \
            $${BASEPATH}/testsamples.cpp \
+           $${BASEPATH}/testserverexecutor.cpp \
            $${BASEPATH}/testsimplifytemplate.cpp \
            $${BASEPATH}/testsimplifytokens.cpp \
            $${BASEPATH}/testsimplifytypedef.cpp \
@@ -17,8 +17,11 @@
  */
 
 #include "importproject.h"
+#include "settings.h"
 #include "testsuite.h"
 
+#include <cstdio>
+#include <fstream>
 #include <list>
 #include <map>
 #include <string>
@@ -45,6 +48,10 @@ private:
         TEST_CASE(setIncludePaths3); // macro names are case insensitive
         TEST_CASE(importCompileCommands1);
         TEST_CASE(importCompileCommands2); // #8563
+        TEST_CASE(importCompileCommands3);
+        TEST_CASE(importCompileCommandsInvalid);
+        TEST_CASE(removeEquivalentFileSettings);
+        TEST_CASE(removeEquivalentFileSettingsIncludes);
     }
 
     void setDefines() const {
@@ -113,6 +120,120 @@ private:
         ASSERT_EQUALS(1, importer.fileSettings.size());
         ASSERT_EQUALS("/tmp/src.c", importer.fileSettings.begin()->filename);
     }
+
+    void importCompileCommands3() const {
+        // Other members are skipped, entries share their include paths
+        const char json[] = "[ { \"directory\": \"/tmp/\", \"arguments\": [\"gcc\", \"-c\"], \"output\": null,"
+                            "\"command\": \"gcc -Iinc -c a.c\", \"file\": \"a.c\" },\n"
+                            "  { \"directory\": \"/tmp/\", \"command\": \"gcc -Iinc -c b.c\", \"file\": \"b\\u00e4.c\", \"nr\": 1.5e3 },\n"
+                            "  { \"directory\": \"/tmp/\", \"command\": \"gcc -DX=\\\"a\\\\/b\\\" -c c.c\", \"file\": \"c.c\" } ]";
+        std::istringstream istr(json);
+        TestImporter importer;
+        importer.importCompileCommands(istr);
+        ASSERT_EQUALS(3, importer.fileSettings.size());
+        std::list<ImportProject::FileSettings>::const_iterator fs = importer.fileSettings.begin();
+        ASSERT_EQUALS("/tmp/a.c", fs->filename);
+        ASSERT_EQUALS(1U, fs->includePaths.size());
+        ASSERT_EQUALS("/tmp/inc/", fs->includePaths.front());
+        ++fs;
+        ASSERT_EQUALS("/tmp/b\xc3\xa4.c", fs->filename);
+        ASSERT_EQUALS(1U, fs->includePaths.size());
+        ASSERT_EQUALS("/tmp/inc/", fs->includePaths.front());
+        ++fs;
+        ASSERT_EQUALS("X=\"a/b\"", fs->defines);
+        ASSERT_EQUALS(0U, fs->includePaths.size());
+    }
+
+    void importCompileCommandsInvalid() const {
+        {
+            std::istringstream istr("[ { \"directory\": \"/tmp\", \"command\": \"gcc -c a.c\", \"file\": \"a.c\" }, { \"file\": ");
+            TestImporter importer;
+            importer.importCompileCommands(istr);
+            ASSERT_EQUALS(0, importer.fileSettings.size());
+        }
+        {
+            std::istringstream istr("{ \"file\": \"a.c\" }");
+            TestImporter importer;
+            importer.importCompileCommands(istr);
+            ASSERT_EQUALS(0, importer.fileSettings.size());
+        }
+    }
+
+    static ImportProject::FileSettings fileSettings(const std::string &cfg, const std::string &defines, const std::string &includePath = "") {
+        ImportProject::FileSettings fs;
+        fs.cfg = cfg;
+        fs.filename = "samples/syntaxError/good.c";
+        fs.setDefines(defines);
+        if (!includePath.empty())
+            fs.includePaths.push_back(includePath);
+        return fs;
+    }
+
+    void removeEquivalentFileSettings() const {
+        // bail out if the tests are not executed from the base folder
+        {
+            std::ifstream fin("samples/syntaxError/good.c");
+            if (!fin.is_open())
+                return;
+        }
+
+        // The file only uses the macro A
+        ImportProject project;
+        project.fileSettings.push_back(fileSettings("Debug", "A=1;B=1"));
+        project.fileSettings.push_back(fileSettings("Release", "A=1;B=2"));
+        project.fileSettings.push_back(fileSettings("Other", "B=1;C=1"));
+        project.fileSettings.push_back(fileSettings("Other2", "C=2"));
+        project.fileSettings.push_back(fileSettings("NoDefines", ""));
+        project.fileSettings.push_back(fileSettings("A2", "A=2;C=1"));
+        project.fileSettings.push_back(fileSettings("Value", "A=C;C=1"));
+        project.fileSettings.push_back(fileSettings("Value2", "A=C;C=2"));
+        project.fileSettings.push_back(fileSettings("Include", "A=1", "include/"));
+        project.fileSettings.push_back(fileSettings("Debug", "A=1;B=1"));
+
+        const Settings settings;
+        ASSERT_EQUALS(3U, project.removeEquivalentFileSettings(settings));
+
+        std::string cfgs;
+        for (const ImportProject::FileSettings &fs : project.fileSettings)
+            cfgs += fs.cfg + ' ';
+        ASSERT_EQUALS("Debug Other NoDefines A2 Value Value2 Include ", cfgs);
+    }
+
+    /** Number of file settings that are removed when the file has the given code */
+    static std::size_t removeEquivalentFileSettings(const char code[], const Settings &settings = Settings()) {
+        {
+            std::ofstream fout("testimportproject.c");
+            fout << code;
+        }
+        ImportProject project;
+        project.fileSettings.push_back(fileSettings("Debug", "A=1;B=1"));
+        project.fileSettings.push_back(fileSettings("Release", "A=1;B=2"));
+        for (ImportProject::FileSettings &fs : project.fileSettings)
+            fs.filename = "testimportproject.c";
+        const std::size_t removed = project.removeEquivalentFileSettings(settings);
+        std::remove("testimportproject.c");
+        return removed;
+    }
+
+    void removeEquivalentFileSettingsIncludes() const {
+        {
+            std::ofstream fout("testimportproject.h");
+            fout << "int a = A;\n";
+        }
+        // B is not used
+        ASSERT_EQUALS(1U, removeEquivalentFileSettings("#include \"testimportproject.h\"\n"));
+        // Headers that are not found are not read when the file is checked either
+        ASSERT_EQUALS(1U, removeEquivalentFileSettings("#include \"testimportproject-missing.h\"\n"));
+        ASSERT_EQUALS(1U, removeEquivalentFileSettings("#include <testimportproject-missing.h>\n"));
+        // The header of a macro #include is not known
+        ASSERT_EQUALS(0U, removeEquivalentFileSettings("#define H \"testimportproject.h\"\n"
+                                                       "#include H\n"));
+        // A define of a library uses B
+        Settings settings;
+        settings.library.defines.push_back("#define LIB_B B\n");
+        ASSERT_EQUALS(0U, removeEquivalentFileSettings("int b = LIB_B;\n", settings));
+        std::remove("testimportproject.h");
+    }
 };
 
 REGISTER_TEST(TestImportProject)
@@ -20,6 +20,8 @@
 #include "mathlib.h"
 #include "testsuite.h"
 
+#include <limits>
+
 struct InternalError;
 
 
@@ -275,6 +277,19 @@ private:
         ASSERT_EQUALS(-1,  MathLib::toLongNumber("-10.E-1"));
         ASSERT_EQUALS(100, MathLib::toLongNumber("+10.0E+1"));
         ASSERT_EQUALS(-1,  MathLib::toLongNumber("-10.0E-1"));
+        ASSERT_EQUALS(0,   MathLib::toLongNumber("0"));
+        ASSERT_EQUALS(0,   MathLib::toLongNumber("-0"));
+        ASSERT_EQUALS(-10, MathLib::toLongNumber("-10"));
+        ASSERT_EQUALS(10,  MathLib::toLongNumber("+10"));
+        ASSERT_EQUALS(10,  MathLib::toLongNumber("10U"));
+        ASSERT_EQUALS(10,  MathLib::toLongNumber("10ul"));
+        ASSERT_EQUALS(10,  MathLib::toLongNumber("10LL"));
+        ASSERT_EQUALS(-10, MathLib::toLongNumber("-10LL"));
+        ASSERT_EQUALS(999999999999999999LL, MathLib::toLongNumber("999999999999999999"));
+        ASSERT_EQUALS(9223372036854775807LL, MathLib::toLongNumber("9223372036854775807"));
+        ASSERT_EQUALS(-1, MathLib::toLongNumber("18446744073709551615"));
+        ASSERT_EQUALS(1000000000000000000LL, MathLib::toLongNumber("1000000000000000000"));
+        ASSERT_EQUALS(-9223372036854775807LL, MathLib::toLongNumber("-9223372036854775807"));
 
         // from char
         ASSERT_EQUALS((int)('A'),    MathLib::toLongNumber("'A'"));
@@ -1121,6 +1136,12 @@ private:
         // double (tailing l or L)
         ASSERT_EQUALS("0",  MathLib::toString(+0.0l));
         ASSERT_EQUALS("-0", MathLib::toString(-0.0L));
+        // integers
+        ASSERT_EQUALS("0",  MathLib::toString(0));
+        ASSERT_EQUALS("-12", MathLib::toString(-12));
+        ASSERT_EQUALS("12", MathLib::toString(12U));
+        ASSERT_EQUALS("-9223372036854775808", MathLib::toString(std::numeric_limits<MathLib::bigint>::min()));
+        ASSERT_EQUALS("18446744073709551615", MathLib::toString(std::numeric_limits<MathLib::biguint>::max()));
     }
 
     void characterLiteralsNormalization() const {
@@ -88,6 +88,13 @@ private:
                                 "}";
             ASSERT_EQUALS(CheckMemoryLeak::NewArray, functionReturnType(code));
         }
+
+        {
+            const char code[] = "char *foo();\n"
+                                "char *bar() { return foo(); }\n"
+                                "char *foo() { return bar(); }";
+            ASSERT_EQUALS(CheckMemoryLeak::No, functionReturnType(code));
+        }
     }
 
     void open() {
@@ -5306,6 +5313,35 @@ private:
               "}");
         ASSERT_EQUALS("[test.cpp:7]: (error) Return value of allocation function 'f' is not stored.\n", errout.str());
 
+        // The allocation type of 'f' is computed at the first call and reused
+        check("void *f();\n"
+              "void x() {\n"
+              "    f();\n"
+              "}\n"
+              "void *f() {\n"
+              "    return malloc(10);\n"
+              "}\n"
+              "void y() {\n"
+              "    f();\n"
+              "}");
+        ASSERT_EQUALS("[test.cpp:3]: (error) Return value of allocation function 'f' is not stored.\n"
+                      "[test.cpp:9]: (error) Return value of allocation function 'f' is not stored.\n", errout.str());
+
+        check("void *f() {\n"
+              "    return malloc(10);\n"
+              "}\n"
+              "void *g() {\n"
+              "    return f();\n"
+              "}\n"
+              "void x() {\n"
+              "    g();\n"
+              "    f();\n"
+              "    g();\n"
+              "}");
+        ASSERT_EQUALS("[test.cpp:8]: (error) Return value of allocation function 'g' is not stored.\n"
+                      "[test.cpp:9]: (error) Return value of allocation function 'f' is not stored.\n"
+                      "[test.cpp:10]: (error) Return value of allocation function 'g' is not stored.\n", errout.str());
+
         check("void f()\n" // #8100
               "{\n"
               "    auto lambda = [](){return malloc(10);};\n"
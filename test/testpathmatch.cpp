@@ -16,6 +16,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "path.h"
 #include "pathmatch.h"
 #include "testsuite.h"
 
@@ -59,6 +60,9 @@ private:
         TEST_CASE(twomasklongerpath2);
         TEST_CASE(twomasklongerpath3);
         TEST_CASE(twomasklongerpath4);
+        TEST_CASE(twomasksameprefix);
+        TEST_CASE(dirmaskpath);
+        TEST_CASE(absolutemask);
         TEST_CASE(filemask1);
         TEST_CASE(filemaskdifferentcase);
         TEST_CASE(filemask2);
@@ -157,6 +161,29 @@ private:
         ASSERT(match.match("project/src/module/"));
     }
 
+    void twomasksameprefix() const {
+        std::vector<std::string> masks = { "src/module/", "src/test/" };
+        PathMatch match(masks);
+        ASSERT(!match.match("src/"));
+        ASSERT(!match.match("src/modules/a.cpp"));
+        ASSERT(match.match("src/module/a.cpp"));
+        ASSERT(match.match("project/src/test/b/"));
+    }
+
+    void dirmaskpath() const {
+        // The directory mask does not match the file name
+        ASSERT(!srcMatcher.match("proj/src"));
+        ASSERT(!srcMatcher.match("src"));
+    }
+
+    void absolutemask() const {
+        std::vector<std::string> masks = { Path::getCurrentPath() + "/src/" };
+        PathMatch match(masks);
+        ASSERT(match.match("src/a.cpp"));
+        ASSERT(match.match(Path::getCurrentPath() + "/src/a.cpp"));
+        ASSERT(!match.match("lib/a.cpp"));
+    }
+
     // Test PathMatch containing "foo.cpp"
     void filemask1() const {
         ASSERT(fooCppMatcher.match("foo.cpp"));
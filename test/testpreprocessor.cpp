@@ -26,7 +26,9 @@
 #include "testsuite.h"
 
 #include <simplecpp.h>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
 #include <list>
 #include <map>
 #include <set>
@@ -141,6 +143,7 @@ private:
         TEST_CASE(macro_incdec);  // separate ++ and -- with space when expanding such macro: '#define M(X)  A-X'
         TEST_CASE(macro_switchCase);
         TEST_CASE(macro_NULL); // skip #define NULL .. it is replaced in the tokenizer
+        TEST_CASE(macro_repeated); // same invocation expanded several times
         TEST_CASE(string1);
         TEST_CASE(string2);
         TEST_CASE(string3);
@@ -232,6 +235,8 @@ private:
         TEST_CASE(getConfigsU6);
         TEST_CASE(getConfigsU7);
 
+        TEST_CASE(getConfigsCache);
+
         TEST_CASE(validateCfg1);
         TEST_CASE(validateCfg2);
 
@@ -248,6 +253,17 @@ private:
         TEST_CASE(testDirectiveIncludeComments);
 
         TEST_CASE(testSameLine);  // #7912
+
+        TEST_CASE(checksum);
+
+        // simplecpp tokenizer
+        TEST_CASE(readfileNames);
+        TEST_CASE(readfileBlanks);
+        TEST_CASE(readfileComments);
+        TEST_CASE(readfileStrings);
+        TEST_CASE(readfileNewlines);
+        TEST_CASE(readfileEof);
+        TEST_CASE(readfileHash);
     }
 
     void preprocess(const char* code, std::map<std::string, std::string>& actual, const char filename[] = "file.c") {
@@ -1070,6 +1086,28 @@ private:
                       OurPreprocessor::expandMacros(filedata));
     }
 
+    void macro_repeated() const {
+        const char filedata[] = "#define ONE 1\n"
+                                "#define TWO (ONE+ONE)\n"
+                                "#define ID(x) x\n"
+                                "#define LINE (__LINE__)\n"
+                                "a = TWO + ID(TWO);\n"
+                                "b = TWO + ID(TWO);\n"
+                                "#undef ONE\n"
+                                "#define ONE 2\n"
+                                "c = TWO + ID(TWO);\n"
+                                "d = LINE; e = LINE;\n"
+                                "f = LINE;\n";
+        ASSERT_EQUALS("\n\n\n\n"
+                      "a = ( 1 + 1 ) + ( 1 + 1 ) ;\n"
+                      "b = ( 1 + 1 ) + ( 1 + 1 ) ;\n"
+                      "\n\n"
+                      "c = ( 2 + 2 ) + ( 2 + 2 ) ;\n"
+                      "d = ( 10 ) ; e = ( 10 ) ;\n"
+                      "f = ( 11 ) ;",
+                      OurPreprocessor::expandMacros(filedata));
+    }
+
     void macro_nopar() const {
         const char filedata[] = "#define AAA( ) { NULL }\n"
                                 "AAA()\n";
@@ -2210,6 +2248,40 @@ private:
         ASSERT_EQUALS("\nY\n", getConfigsStr(code, "-DX"));
     }
 
+    std::string getConfigsCacheStr(const char header[], ConfigsCache &configsCache) {
+        {
+            std::ofstream fout("testconfigscache.h");
+            fout << header;
+        }
+        Preprocessor preprocessor(settings0, this);
+        std::vector<std::string> files;
+        std::istringstream istr("#include \"testconfigscache.h\"\n");
+        simplecpp::TokenList tokens(istr, files, "testconfigscache.c");
+        preprocessor.loadFiles(tokens, files);
+        const std::set<std::string> configs = preprocessor.getConfigs(tokens, &configsCache);
+        std::remove("testconfigscache.h");
+        std::string ret;
+        for (std::set<std::string>::const_iterator it = configs.begin(); it != configs.end(); ++it)
+            ret += *it + '\n';
+        return ret;
+    }
+
+    void getConfigsCache() {
+        ConfigsCache configsCache;
+        ASSERT_EQUALS("\nFOO\n", getConfigsCacheStr("#ifdef FOO\n#endif\n", configsCache));
+        ASSERT_EQUALS("\nFOO\n", getConfigsCacheStr("#ifdef FOO\n#endif\n", configsCache));
+        // the header is changed between the calls
+        ASSERT_EQUALS("\nBAR\n", getConfigsCacheStr("#ifdef BAR\n#endif\n", configsCache));
+        ASSERT_EQUALS("\nA\nA;B\n", getConfigsCacheStr("#ifdef A\n#ifdef B\n#endif\n#endif\n", configsCache));
+        ASSERT_EQUALS("\nA\nB\n", getConfigsCacheStr("#ifdef A\n#endif\n#ifdef B\n#endif\n", configsCache));
+        // the configurations are cached for each set of -D and -U options
+        settings0.userUndefs.insert("A");
+        ASSERT_EQUALS("\nB\n", getConfigsCacheStr("#ifdef A\n#endif\n#ifdef B\n#endif\n", configsCache));
+        settings0.userUndefs.clear();
+        ASSERT_EQUALS("\nA\nB\n", getConfigsCacheStr("#ifdef A\n#endif\n#ifdef B\n#endif\n", configsCache));
+        ASSERT_EQUALS(2U, configsCache.headers.size());
+    }
+
 
     void validateCfg1() {
         Preprocessor preprocessor(settings0, this);
@@ -2386,6 +2458,155 @@ private:
         ASSERT_EQUALS(exp, preprocessor.getcode(code, "", "test.cpp"));
     }
 
+    unsigned long long checksum(const char code[], const std::string &toolinfo = "") {
+        std::istringstream istr(code);
+        std::vector<std::string> files;
+        const simplecpp::TokenList tokens(istr, files, "test.c");
+        return preprocessor0.calculateChecksum(tokens, toolinfo);
+    }
+
+    void checksum() {
+        ASSERT_EQUALS(checksum("int a;"), checksum("int  a ; // comment"));
+        ASSERT(checksum("int a;") != checksum("int b;"));
+        ASSERT(checksum("a bc") != checksum("ab c"));
+        ASSERT(checksum("int a;", "w") != checksum("int a;", "s"));
+    }
+
+    /** The tokens of the code as "str@line:col", and the diagnostics */
+    static std::string readfile(const std::string &code, bool stream = false) {
+        std::vector<std::string> files;
+        simplecpp::OutputList outputList;
+        std::istringstream istr(code);
+        const simplecpp::TokenList tokens = stream ?
+                                            simplecpp::TokenList(istr, files, "test.c", &outputList) :
+                                            simplecpp::TokenList(code.data(), code.size(), files, "test.c", &outputList);
+        std::string ret;
+        for (const simplecpp::Token *tok = tokens.cfront(); tok; tok = tok->next) {
+            if (!ret.empty())
+                ret += ' ';
+            ret += tok->str() + '@' + std::to_string(tok->location.line) + ':' + std::to_string(tok->location.col);
+        }
+        for (const simplecpp::Output &output : outputList)
+            ret += " [" + output.msg + ']';
+        return ret;
+    }
+
+    void readfileNames() {
+        ASSERT_EQUALS("abc_1$x@1:1 y@1:9", readfile("abc_1$x y"));
+        ASSERT_EQUALS("a@1:1 +@1:2 b@1:3", readfile("a+b"));
+        ASSERT_EQUALS("0x1f@1:1 ;@1:5", readfile("0x1f;"));
+        ASSERT_EQUALS("1000000@1:1", readfile("1'000'000"));
+        // only ASCII letters, digits, '_' and '$' are name characters
+        ASSERT_EQUALS("ab@1:1 .@1:3 c@1:4", readfile("ab.c"));
+        ASSERT_EQUALS(" [The code contains unhandled character(s) (character code=233). Neither unicode nor extended ascii is supported.]",
+                      readfile("ab\xe9"));
+        // name at the end of the input
+        ASSERT_EQUALS("x@1:1", readfile("x"));
+        ASSERT_EQUALS("x@1:1 yz@1:3", readfile("x yz"));
+        ASSERT_EQUALS(readfile("abc_1$x y.z 1'000 z", true), readfile("abc_1$x y.z 1'000 z"));
+    }
+
+    void readfileBlanks() {
+        ASSERT_EQUALS("a@1:1 b@1:7", readfile("a \t\v\f b"));
+        ASSERT_EQUALS("a@1:3 b@2:3", readfile("  a\n  b"));
+        // control characters are blanks
+        ASSERT_EQUALS("a@1:1 b@1:3", readfile("a\x01" "b"));
+        ASSERT_EQUALS("a@1:1 b@1:5", readfile("a \t\x01" "b"));
+        // blanks at the end of the input
+        ASSERT_EQUALS("a@1:1", readfile("a   "));
+        ASSERT_EQUALS("", readfile("   "));
+        ASSERT_EQUALS(readfile(" a \t\v\f b \x01" "c  ", true), readfile(" a \t\v\f b \x01" "c  "));
+    }
+
+    void readfileComments() {
+        ASSERT_EQUALS("x@1:1 // abc@1:3 y@2:1", readfile("x // abc\ny"));
+        ASSERT_EQUALS("/* a ** b */@1:1 y@1:14", readfile("/* a ** b */ y"));
+        ASSERT_EQUALS("/**/@1:1 y@1:5", readfile("/**/y"));
+        ASSERT_EQUALS("/* a\nb */@1:1 y@2:6", readfile("/* a\nb */ y"));
+        // comment ends at the end of the input
+        ASSERT_EQUALS("x@1:1 // abc@1:3", readfile("x // abc"));
+        ASSERT_EQUALS("x@1:1 /* abc@1:3", readfile("x /* abc"));
+        ASSERT_EQUALS("x@1:1 /* abc *@1:3", readfile("x /* abc *"));
+        // backslash-newline continues a line comment
+        ASSERT_EQUALS("// a @1:1 b@1:6 c@3:1", readfile("// a \\\nb\nc"));
+        ASSERT_EQUALS(readfile("x // abc\n/* a ** b\n */ y /* abc", true), readfile("x // abc\n/* a ** b\n */ y /* abc"));
+    }
+
+    void readfileStrings() {
+        ASSERT_EQUALS("\"a b\"@1:1 ;@1:6", readfile("\"a b\";"));
+        ASSERT_EQUALS("'a'@1:1", readfile("'a'"));
+        // string ends at the end of the input
+        ASSERT_EQUALS(" [No pair for character (\"). Can't process file. File is either invalid or unicode, which is currently not supported.]",
+                      readfile("x \"abc"));
+        // backslash-newline in a string
+        ASSERT_EQUALS("\"ab\"@1:1 x@2:4", readfile("\"a\\\nb\" x"));
+    }
+
+    void readfileNewlines() {
+        ASSERT_EQUALS("a@1:1 b@2:1 // c@2:3 d@3:1", readfile("a\r\nb // c\r\nd"));
+        ASSERT_EQUALS("a@1:1 b@2:1 c@3:1", readfile("a\rb\rc"));
+        ASSERT_EQUALS("/* a\nb */@1:1 c@2:6", readfile("/* a\r\nb */ c"));
+        // backslash-newline in a line comment with CRLF
+        ASSERT_EQUALS("// a @1:1 b@1:6 c@3:1", readfile("// a \\\r\nb\r\nc"));
+        // CRLF at the end of the input
+        ASSERT_EQUALS("a@1:1", readfile("a\r\n"));
+        ASSERT_EQUALS("a@1:1", readfile("a\r"));
+        ASSERT_EQUALS(readfile("a\r\nb // c\r\n/* a\r\nb */\r\n// a \\\r\nb\r", true), readfile("a\r\nb // c\r\n/* a\r\nb */\r\n// a \\\r\nb\r"));
+    }
+
+    // The character after the last one is peeked or read and then unget.
+    // Both constructors must behave like reading from an std::istream.
+    void readfileEof() {
+        const char * const code[] = {
+            "", " ", "\n", "1", "12", "/", "a/", "#", "x#", "\\", "a\\",
+            "a<", "a<<", "a<<=", "x\r", "x\\\n"
+        };
+        for (const char *c : code)
+            ASSERT_EQUALS(readfile(c, true), readfile(c));
+
+        // empty input
+        ASSERT_EQUALS("", readfile(""));
+        ASSERT_EQUALS("", readfile("\n"));
+
+        // unget at the end of the input
+        ASSERT_EQUALS("12@1:1", readfile("12"));
+        ASSERT_EQUALS("/@1:1", readfile("/"));
+        ASSERT_EQUALS("a@1:1 /@1:2", readfile("a/"));
+        ASSERT_EQUALS("a@1:1 \\@1:2", readfile("a\\"));
+        ASSERT_EQUALS("a@1:1 <<=@1:2", readfile("a<<="));
+        ASSERT_EQUALS("x@1:1", readfile("x\\\n"));
+
+        // BOM, partial BOM and UTF-16 at the end of the input
+        ASSERT_EQUALS("x@1:1", readfile("\xef\xbb\xbf" "x"));
+        ASSERT_EQUALS("", readfile("\xef"));
+        ASSERT_EQUALS(" [The code contains unhandled character(s) (character code=239). Neither unicode nor extended ascii is supported.]",
+                      readfile("\xef\xbb"));
+        ASSERT_EQUALS("", readfile("\xfe\xff"));
+        ASSERT_EQUALS("x@1:1", readfile(std::string("\xfe\xff\0x", 4)));
+        ASSERT_EQUALS("x@1:1", readfile(std::string("\xff\xfe" "x\0", 4)));
+        ASSERT_EQUALS("", readfile(std::string("\xfe\xff\0", 3)));
+        ASSERT_EQUALS(readfile(std::string("\xfe\xff\0", 3), true), readfile(std::string("\xfe\xff\0", 3)));
+        ASSERT_EQUALS(readfile("\xef\xbb", true), readfile("\xef\xbb"));
+    }
+
+    void readfileHash() {
+        std::vector<std::string> files;
+        const std::string code1 = "#ifdef A\n#endif\n// 12345678\n";
+        const std::string code2 = "#ifdef B\n#endif\n// 12345678\n";
+        const simplecpp::TokenList tokens1(code1.data(), code1.size(), files);
+        const simplecpp::TokenList tokens2(code2.data(), code2.size(), files);
+        std::istringstream istr(code1);
+        const simplecpp::TokenList tokens3(istr, files);
+        ASSERT(tokens1.dataHash() != tokens2.dataHash());
+        ASSERT_EQUALS(tokens1.dataHash(), tokens3.dataHash());
+        const simplecpp::TokenList copy(tokens1);
+        ASSERT_EQUALS(tokens1.dataHash(), copy.dataHash());
+        // Only the changed byte differs
+        const std::string code4 = code1.substr(0, code1.size() - 2U) + "9\n";
+        const simplecpp::TokenList tokens4(code4.data(), code4.size(), files);
+        ASSERT(tokens1.dataHash() != tokens4.dataHash());
+    }
+
 };
 
 REGISTER_TEST(TestPreprocessor)
@@ -0,0 +1,176 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2018 Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "serverexecutor.h"
+#include "settings.h"
+#include "testsuite.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#ifdef SERVER_MODEL_UNIX
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+class TestServerExecutor : public TestFixture {
+public:
+    TestServerExecutor() : TestFixture("TestServerExecutor") {
+    }
+
+private:
+    Settings settings;
+
+    static std::string checkRequest(const std::string &filename, const std::string &code, const std::string &options = "") {
+        return "check " + filename + "\n" + options + "content " + std::to_string(code.size()) + "\n" + code + "end\n";
+    }
+
+    /** Send the requests to a new server and return its response */
+    std::string serve(const std::string &requests, bool *quit = nullptr) {
+        ServerExecutor server("", settings, "cppcheck");
+        return serve(server, requests, quit);
+    }
+
+    /** Send the requests to the server and return its response */
+    static std::string serve(ServerExecutor &server, const std::string &requests, bool *quit = nullptr) {
+#ifdef SERVER_MODEL_UNIX
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+            return "";
+        if (write(fds[0], requests.data(), requests.size()) != static_cast<ssize_t>(requests.size()))
+            return "";
+        shutdown(fds[0], SHUT_WR);
+
+        const bool ret = server.serve(fds[1]);
+        if (quit)
+            *quit = ret;
+        close(fds[1]);
+
+        std::string response;
+        char buf[1024];
+        ssize_t len;
+        while ((len = read(fds[0], buf, sizeof(buf))) > 0)
+            response.append(buf, static_cast<std::size_t>(len));
+        close(fds[0]);
+        return response;
+#else
+        (void)server;
+        (void)requests;
+        (void)quit;
+        return "";
+#endif
+    }
+
+    void run() override {
+        if (!ServerExecutor::isEnabled())
+            return;
+
+        settings.quiet = true;
+
+        TEST_CASE(content);
+        TEST_CASE(options);
+        TEST_CASE(badRequests);
+        TEST_CASE(headerChanged);
+        TEST_CASE(socketPathNotSocket);
+    }
+
+    void content() {
+        const char code[] = "void f() {\n"
+                            "    int a[2];\n"
+                            "    a[5] = 0;\n"
+                            "}\n";
+        ASSERT_EQUALS("error [test.cpp:3]: (error) Array 'a[2]' accessed at index 5, which is out of bounds.\n"
+                      "done 1\n",
+                      serve(checkRequest("test.cpp", code)));
+    }
+
+    void options() {
+        const char code[] = "void f(int x) {\n"
+                            "    if (x == x) {}\n"
+                            "}\n";
+        // Options only apply to their own request
+        ASSERT_EQUALS("error [test.cpp:2]: (style) Same expression on both sides of '=='.\n"
+                      "done 1\n"
+                      "done 0\n",
+                      serve(checkRequest("test.cpp", code, "option --enable=style\n") +
+                            checkRequest("test.cpp", code)));
+
+        ASSERT_EQUALS("fail invalid options\n", serve(checkRequest("test.cpp", code, "option --enable=foo\n")));
+    }
+
+    void badRequests() {
+        bool quit = false;
+        ASSERT_EQUALS("fail unknown request 'hello'\n"
+                      "fail no file given\n",
+                      serve("hello\nend\nquit\ncheck test.cpp\nend\n", &quit));
+        ASSERT_EQUALS(true, quit);
+
+        ASSERT_EQUALS("fail invalid content size 'x'\n", serve("check test.cpp\ncontent x\n", &quit));
+        ASSERT_EQUALS(false, quit);
+
+        ASSERT_EQUALS("fail content size '1000000000' is too large\n", serve("check test.cpp\ncontent 1000000000\n", &quit));
+        ASSERT_EQUALS("fail content size '123456789012345678901234567890' is too large\n", serve("check test.cpp\ncontent 123456789012345678901234567890\n", &quit));
+        ASSERT_EQUALS(false, quit);
+    }
+
+    void headerChanged() {
+        // The header configurations are reused between requests, an
+        // edited header must not give the configurations of the old one
+        const char code[] = "#include \"testserverexecutor.h\"\n";
+        ServerExecutor server("", settings, "cppcheck");
+        {
+            std::ofstream fout("testserverexecutor.h");
+            fout << "#ifdef A\n"
+                 "#endif\n";
+        }
+        const std::string first = serve(server, checkRequest("test.cpp", code));
+        {
+            std::ofstream fout("testserverexecutor.h");
+            fout << "#ifdef B\n"
+                 "void f() { int a[2]; a[5] = 0; }\n"
+                 "#endif\n";
+        }
+        const std::string second = serve(server, checkRequest("test.cpp", code));
+        std::remove("testserverexecutor.h");
+
+        ASSERT_EQUALS("done 0\n", first);
+        ASSERT_EQUALS("error [testserverexecutor.h:2]: (error) Array 'a[2]' accessed at index 5, which is out of bounds.\n"
+                      "done 1\n", second);
+    }
+
+    void socketPathNotSocket() {
+#ifdef SERVER_MODEL_UNIX
+        // An existing file that is not a socket is not removed
+        {
+            std::ofstream fout("testserverexecutor.sock");
+            fout << "data";
+        }
+        ServerExecutor server("testserverexecutor.sock", settings, "cppcheck");
+        ASSERT_EQUALS(EXIT_FAILURE, server.run());
+        struct stat st;
+        ASSERT_EQUALS(0, lstat("testserverexecutor.sock", &st));
+        ASSERT(S_ISREG(st.st_mode));
+        std::remove("testserverexecutor.sock");
+#endif
+    }
+};
+
+REGISTER_TEST(TestServerExecutor)
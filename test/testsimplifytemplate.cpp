@@ -132,6 +132,7 @@ private:
         TEST_CASE(template92);
         TEST_CASE(template93); // crash
         TEST_CASE(template94); // #8927 crash
+        TEST_CASE(template95); // out of line member functions after function bodies
         TEST_CASE(template_specialization_1);  // #7868 - template specialization template <typename T> struct S<C<T>> {..};
         TEST_CASE(template_specialization_2);  // #7868 - template specialization template <typename T> struct S<C<T>> {..};
         TEST_CASE(template_enum);  // #6299 Syntax error in complex enum declaration (including template)
@@ -1905,6 +1906,39 @@ private:
         ASSERT_EQUALS(exp, tok(code));
     }
 
+    void template95() { // out of line member functions after function bodies
+        const char code[] = "template <class T> struct A { int f() const; void g(); };\n"
+                            "int x[] = { 1, 2 };\n"
+                            "void h(B b) { b.template get<0>(); }\n"
+                            "template <class T> int A<T>::f() const { return T(); }\n"
+                            "void k() { }\n"
+                            "template <class T> void A<T>::g() { f(); }\n"
+                            "A<int> a;";
+        const char exp[] = "struct A<int> ; int x [ 2 ] = { 1 , 2 } ; void h ( B b ) { b . template get < 0 > ( ) ; } void k ( ) { } A<int> a ; struct A<int> { int f ( ) const ; void g ( ) ; } ; int A<int> :: f ( ) const { return int ( ) ; } void A<int> :: g ( ) { f ( ) ; }";
+        ASSERT_EQUALS(exp, tok(code));
+
+        // The return type of an out of line member function is not replaced
+        const char code2[] = "template <class T> struct A { T f() const; };\n"
+                             "void k() { }\n"
+                             "template <class T> T A<T>::f() const { return T(); }\n"
+                             "A<int> a;";
+        const char exp2[] = "struct A<int> ; void k ( ) { } A<int> a ; struct A<int> { int f ( ) const ; } ; int A<int> :: f ( ) const { return int ( ) ; }";
+        const char cur2[] = "struct A<int> ; void k ( ) { } A<int> a ; struct A<int> { int f ( ) const ; } ; T A<int> :: f ( ) const { return int ( ) ; }";
+        TODO_ASSERT_EQUALS(exp2, cur2, tok(code2));
+
+        // A class head that ends with ')' is not a function head
+        const char code3[] = "struct alignas(8) Outer { template<class T> struct Inner { T x; T get() const; }; };\n"
+                             "template<class T> T Outer::Inner<T>::get() const { return x; }\n"
+                             "Outer::Inner<int> i;";
+        const char exp3[] = "struct alignas ( 8 ) { struct Inner<int> ; } ; Outer :: Inner<int> i ; struct Inner<int> { int x ; int get ( ) const ; } ; T Outer :: Inner<int> :: get ( ) const { return x ; }";
+        ASSERT_EQUALS(exp3, tok(code3));
+        const char code4[] = "struct Outer : decltype(base()) { template<class T> struct Inner { T x; T get() const; }; };\n"
+                             "template<class T> T Outer::Inner<T>::get() const { return x; }\n"
+                             "Outer::Inner<int> i;";
+        const char exp4[] = "struct Outer : decltype ( base ( ) ) { struct Inner<int> ; } ; Outer :: Inner<int> i ; struct Outer :: Inner<int> { int x ; int get ( ) const ; } ; T Outer :: Inner<int> :: get ( ) const { return x ; }";
+        ASSERT_EQUALS(exp4, tok(code4));
+    }
+
     void template_specialization_1() {  // #7868 - template specialization template <typename T> struct S<C<T>> {..};
         const char code[] = "template <typename T> struct C {};\n"
                             "template <typename T> struct S {a};\n"
@@ -19,8 +19,11 @@
 #include "testsuite.h"
 #include "timer.h"
 
+#include <algorithm>
 #include <cmath>
 #include <ctime>
+#include <map>
+#include <string>
 
 class TestTimer : public TestFixture {
 public:
@@ -31,6 +34,7 @@ private:
 
     void run() override {
         TEST_CASE(result);
+        TEST_CASE(memoryUsage);
     }
 
     void result() const {
@@ -41,6 +45,72 @@ private:
         t1.mClocks = CLOCKS_PER_SEC * 5 / 2;
         ASSERT(std::fabs(t1.seconds()-2.5) < 0.01);
     }
+
+    class MemoryResults : public TimerResultsIntf {
+    public:
+        void AddResults(const std::string&, std::clock_t) override {}
+        void AddMemoryResults(const std::string& str, const MemoryUsage &usage) override {
+            results[str] = usage;
+        }
+        std::map<std::string, MemoryUsage> results;
+    };
+
+    void memoryUsage() const {
+        // Feed the counters by hand, the real allocations are not counted
+        const bool supported = MemoryCounters::supported;
+        const bool active = MemoryCounters::active;
+        MemoryCounters::supported = true;
+        MemoryCounters::active = false;
+        const long long peakBefore = MemoryCounters::peakBytes;
+        const long long live = MemoryCounters::liveBytes;
+
+        MemoryResults results;
+        {
+            Timer outer("outer", SHOWTIME_NONE, &results, SHOWTIME_SUMMARY);
+            MemoryCounters::allocated(1000);
+            MemoryCounters::deallocated(1000);
+            {
+                // The peak of the outer phase is not the peak of this phase
+                Timer inner("inner", SHOWTIME_NONE, &results, SHOWTIME_SUMMARY);
+                MemoryCounters::allocated(300);
+                MemoryCounters::deallocated(300);
+            }
+            // .. but it is restored when this phase ends
+            ASSERT_EQUALS(live + 1000, MemoryCounters::peakBytes);
+            MemoryCounters::allocated(200);
+            MemoryCounters::deallocated(200);
+        }
+        // Memory that was in use before a phase is not part of its peak
+        MemoryCounters::allocated(5000);
+        {
+            Timer later("later", SHOWTIME_NONE, &results, SHOWTIME_SUMMARY);
+            MemoryCounters::allocated(10);
+        }
+        MemoryCounters::deallocated(5010);
+
+        ASSERT_EQUALS(1U, results.results["inner"].allocations);
+        ASSERT_EQUALS(300U, results.results["inner"].allocatedBytes);
+        ASSERT_EQUALS(300, results.results["inner"].peakBytes);
+        ASSERT_EQUALS(3U, results.results["outer"].allocations);
+        ASSERT_EQUALS(1500U, results.results["outer"].allocatedBytes);
+        ASSERT_EQUALS(1000, results.results["outer"].peakBytes);
+        ASSERT_EQUALS(1U, results.results["later"].allocations);
+        ASSERT_EQUALS(10, results.results["later"].peakBytes);
+        ASSERT_EQUALS(std::max(peakBefore, live + 5010), MemoryCounters::peakBytes);
+        ASSERT_EQUALS(live, MemoryCounters::liveBytes);
+
+        // Nothing is recorded when allocations can't be tracked
+        MemoryCounters::supported = false;
+        {
+            Timer t("unsupported", SHOWTIME_NONE, &results, SHOWTIME_SUMMARY);
+            MemoryCounters::allocated(10);
+            MemoryCounters::deallocated(10);
+        }
+        ASSERT_EQUALS(0U, results.results.count("unsupported"));
+
+        MemoryCounters::supported = supported;
+        MemoryCounters::active = active;
+    }
 };
 
 REGISTER_TEST(TestTimer)
@@ -21,6 +21,7 @@
 #include "preprocessor.h" // usually tests here should not use preprocessor...
 #include "settings.h"
 #include "standards.h"
+#include "symboldatabase.h"
 #include "testsuite.h"
 #include "token.h"
 #include "tokenize.h"
@@ -483,6 +484,9 @@ private:
 
         // --check-config
         TEST_CASE(checkConfiguration);
+
+        TEST_CASE(simplifyTokenList2Analysis);
+        TEST_CASE(analysisLevels);
     }
 
     std::string tokenizeAndStringify(const char code[], bool simplify = false, bool expand = true, Settings::PlatformType platform = Settings::Native, const char* filename = "test.cpp", bool cpp11 = true) {
@@ -8510,6 +8514,9 @@ private:
         ASSERT_EQUALS("Abc({newreturn", testAst("return new A {b(c)};"));
         ASSERT_EQUALS("a{{return", testAst("return{{a}};"));
         ASSERT_EQUALS("a{b{,{return", testAst("return{{a},{b}};"));
+        ASSERT_EQUALS("a{b{,c{,{return", testAst("return{{a},{b},{c}};"));
+        ASSERT_EQUALS("xX1{2{,3{,{=", testAst("x = X{{1}, {2}, {3}};"));
+        ASSERT_EQUALS("S{ s[1{2{,3{,{=", testAst("struct S {} s[] = {{1}, {2}, {3}};"));
     }
 
     void astbrackets() { // []
@@ -8760,6 +8767,72 @@ private:
         checkConfig("void f() { DEBUG(x();y()); }");
         ASSERT_EQUALS("[test.cpp:1]: (information) Ensure that 'DEBUG' is defined either using -I, --include or -D.\n", errout.str());
     }
+
+    void simplifyTokenList2Analysis() {
+        // Nothing is simplified, the analysis of the normal token list is reused
+        {
+            Tokenizer tokenizer(&settings0, this);
+            std::istringstream istr("int f(int x) { return x + 1; }");
+            ASSERT(tokenizer.tokenize(istr, "test.cpp"));
+            const unsigned long long changes = tokenizer.list.changes();
+            ASSERT(tokenizer.simplifyTokenList2());
+            ASSERT_EQUALS(changes, tokenizer.list.changes());
+            ASSERT_EQUALS(1U, tokenizer.getSymbolDatabase()->functionScopes.size());
+            const Token *plus = Token::findsimplematch(tokenizer.tokens(), "+");
+            ASSERT_EQUALS("x1+", plus->astString());
+            ASSERT(plus->astOperand2()->hasKnownIntValue());
+            ASSERT(plus->astOperand1()->variable() != nullptr);
+        }
+
+        // The simplified tokens are analysed again
+        {
+            Tokenizer tokenizer(&settings0, this);
+            std::istringstream istr("int f(int x) { return x + (1 + 2); }");
+            ASSERT(tokenizer.tokenize(istr, "test.cpp"));
+            const unsigned long long changes = tokenizer.list.changes();
+            ASSERT(tokenizer.simplifyTokenList2());
+            ASSERT(changes != tokenizer.list.changes());
+            ASSERT_EQUALS(1U, tokenizer.getSymbolDatabase()->functionScopes.size());
+            const Token *plus = Token::findsimplematch(tokenizer.tokens(), "+");
+            ASSERT_EQUALS("x3+", plus->astString());
+            ASSERT(plus->astOperand2()->hasKnownIntValue());
+            ASSERT_EQUALS(3, plus->astOperand2()->values().front().intvalue);
+            ASSERT(plus->astOperand1()->variable() != nullptr);
+        }
+    }
+
+    void analysisLevels() {
+        // Only the AST
+        Tokenizer tokenizer(&settings0, this);
+        std::istringstream istr("int f(int x) { return x + 1; }");
+        ASSERT(tokenizer.createTokens(istr, "test.cpp"));
+        ASSERT(tokenizer.simplifyTokens1("", Tokenizer::ANALYSIS_AST));
+        ASSERT_EQUALS(Tokenizer::ANALYSIS_AST, tokenizer.analysis());
+        ASSERT(tokenizer.getSymbolDatabase() == nullptr);
+        const Token *plus = Token::findsimplematch(tokenizer.tokens(), "+");
+        ASSERT_EQUALS("x1+", plus->astString());
+        ASSERT(plus->astOperand1()->variable() == nullptr);
+        ASSERT(plus->astOperand2()->values().empty());
+
+        // The symbol database, but no values
+        tokenizer.analyse(Tokenizer::ANALYSIS_SYMBOLDATABASE);
+        ASSERT_EQUALS(Tokenizer::ANALYSIS_SYMBOLDATABASE, tokenizer.analysis());
+        ASSERT(tokenizer.getSymbolDatabase() != nullptr);
+        ASSERT(plus->astOperand1()->variable() != nullptr);
+        ASSERT(plus->valueType() != nullptr);
+        ASSERT(plus->astOperand2()->values().empty());
+
+        // The analysis is never reduced
+        tokenizer.analyse(Tokenizer::ANALYSIS_AST);
+        ASSERT_EQUALS(Tokenizer::ANALYSIS_SYMBOLDATABASE, tokenizer.analysis());
+
+        // The simplified token list gets the values too
+        ASSERT(tokenizer.simplifyTokenList2());
+        ASSERT_EQUALS(Tokenizer::ANALYSIS_VALUEFLOW, tokenizer.analysis());
+        plus = Token::findsimplematch(tokenizer.tokens(), "+");
+        ASSERT(plus->astOperand1()->variable() != nullptr);
+        ASSERT(plus->astOperand2()->hasKnownIntValue());
+    }
 };
 
 REGISTER_TEST(TestTokenizer)
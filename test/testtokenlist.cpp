@@ -16,6 +16,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "errorlogger.h"
 #include "settings.h"
 #include "testsuite.h"
 #include "token.h"
@@ -36,6 +37,8 @@ private:
         TEST_CASE(testaddtoken1);
         TEST_CASE(testaddtoken2);
         TEST_CASE(inc);
+        TEST_CASE(changes);
+        TEST_CASE(validateAst);
     }
 
     // inspired by #5895
@@ -73,6 +76,49 @@ private:
 
         ASSERT(Token::simpleMatch(tokenlist.front(), "a + + 1 ; 1 + + b ;"));
     }
+
+    void changes() const {
+        TokenList tokenlist(&settings);
+        std::istringstream istr("a = b ;");
+        tokenlist.createTokens(istr, "a.cpp");
+        Token *tok = tokenlist.front();
+
+        unsigned long long changes = tokenlist.changes();
+        tok->isUnsigned(false);
+        tok->link(nullptr);
+        (void)Token::simpleMatch(tok, "a =");
+        ASSERT_EQUALS(changes, tokenlist.changes());
+
+        tok->varId(1);
+        ASSERT(changes < tokenlist.changes());
+
+        changes = tokenlist.changes();
+        tok->insertToken("c");
+        ASSERT(changes < tokenlist.changes());
+
+        changes = tokenlist.changes();
+        tok->deleteNext();
+        ASSERT(changes < tokenlist.changes());
+
+        changes = tokenlist.changes();
+        tok->next()->str("+=");
+        ASSERT(changes < tokenlist.changes());
+    }
+
+    void validateAst() const {
+        TokenList tokenlist(&settings);
+        std::istringstream istr("x = a + b + c ;");
+        tokenlist.createTokens(istr, "a.cpp");
+        tokenlist.createAst();
+        tokenlist.validateAst();
+
+        // x = ((a + b) + c), make the first + the parent of =
+        Token *assign = tokenlist.front()->next();
+        Token *plus1 = assign->tokAt(2);
+        ASSERT(assign == plus1->astParent()->astParent());
+        plus1->astOperand2(assign);
+        ASSERT_THROW(tokenlist.validateAst(), InternalError);
+    }
 };
 
 REGISTER_TEST(TestTokenList)
@@ -26,6 +26,7 @@
 
 #include <simplecpp.h>
 #include <cmath>
+#include <iterator>
 #include <list>
 #include <map>
 #include <ostream>
@@ -64,6 +65,7 @@ private:
         TEST_CASE(valueFlowSizeof);
 
         TEST_CASE(valueFlowErrorPath);
+        TEST_CASE(valueFlowErrorPathCopy);
 
         TEST_CASE(valueFlowBeforeCondition);
         TEST_CASE(valueFlowBeforeConditionAndAndOrOrGuard);
@@ -144,7 +146,7 @@ private:
 
         for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next()) {
             if (tok->str() == "x" && tok->linenr() == linenr) {
-                std::list<ValueFlow::Value>::const_iterator it;
+                std::vector<ValueFlow::Value>::const_iterator it;
                 for (it = tok->values().begin(); it != tok->values().end(); ++it) {
                     if (it->isIntValue() && it->intvalue == value)
                         return true;
@@ -163,7 +165,7 @@ private:
 
         for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next()) {
             if (tok->str() == "x" && tok->linenr() == linenr) {
-                std::list<ValueFlow::Value>::const_iterator it;
+                std::vector<ValueFlow::Value>::const_iterator it;
                 for (it = tok->values().begin(); it != tok->values().end(); ++it) {
                     if (it->isFloatValue() && it->floatValue >= value - diff && it->floatValue <= value + diff)
                         return true;
@@ -185,7 +187,7 @@ private:
                 continue;
 
             std::ostringstream ostr;
-            std::list<ValueFlow::Value>::const_iterator it;
+            std::vector<ValueFlow::Value>::const_iterator it;
             for (it = tok->values().begin(); it != tok->values().end(); ++it) {
                 for (ValueFlow::Value::ErrorPath::const_iterator ep = it->errorPath.begin(); ep != it->errorPath.end(); ++ep) {
                     const Token *eptok = ep->first;
@@ -207,7 +209,7 @@ private:
 
         for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next()) {
             if (tok->str() == "x" && tok->linenr() == linenr) {
-                std::list<ValueFlow::Value>::const_iterator it;
+                std::vector<ValueFlow::Value>::const_iterator it;
                 for (it = tok->values().begin(); it != tok->values().end(); ++it) {
                     if (it->valueType == type && Token::simpleMatch(it->tokvalue, value))
                         return true;
@@ -226,7 +228,7 @@ private:
 
         for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next()) {
             if (tok->str() == "x" && tok->linenr() == linenr) {
-                std::list<ValueFlow::Value>::const_iterator it;
+                std::vector<ValueFlow::Value>::const_iterator it;
                 for (it = tok->values().begin(); it != tok->values().end(); ++it) {
                     if (it->isMovedValue() && it->moveKind == moveKind)
                         return true;
@@ -245,7 +247,7 @@ private:
 
         for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next()) {
             if (tok->str() == "x" && tok->linenr() == linenr) {
-                std::list<ValueFlow::Value>::const_iterator it;
+                std::vector<ValueFlow::Value>::const_iterator it;
                 for (it = tok->values().begin(); it != tok->values().end(); ++it) {
                     if (it->isIntValue() && it->intvalue == value && it->condition)
                         return true;
@@ -282,7 +284,7 @@ private:
         errout.str("");
         tokenizer.tokenize(istr, "test.cpp");
         const Token *tok = Token::findmatch(tokenizer.tokens(), tokstr);
-        return tok ? tok->values() : std::list<ValueFlow::Value>();
+        return tok ? std::list<ValueFlow::Value>(tok->values().begin(), tok->values().end()) : std::list<ValueFlow::Value>();
     }
 
     ValueFlow::Value valueOfTok(const char code[], const char tokstr[]) {
@@ -952,6 +954,46 @@ private:
                       getErrorPathForX(code, 4U));
     }
 
+    void valueFlowErrorPathCopy() {
+        ValueFlow::Value value(1);
+        value.errorPath.emplace_back(nullptr, "first");
+
+        // Copies share the error path until one of them is extended
+        ValueFlow::Value copy(value);
+        ASSERT_EQUALS(true, &static_cast<const ErrorPath &>(copy.errorPath) == &static_cast<const ErrorPath &>(value.errorPath));
+        copy.errorPath.emplace_back(nullptr, "second");
+        ASSERT_EQUALS(2U, copy.errorPath.size());
+        ASSERT_EQUALS(1U, value.errorPath.size());
+        ASSERT_EQUALS("first", value.errorPath.begin()->second);
+        ASSERT_EQUALS("second", std::next(copy.errorPath.begin())->second);
+
+        // A value that owns its error path alone extends it in place
+        const ErrorPath *path = &static_cast<const ErrorPath &>(value.errorPath);
+        value.errorPath.emplace_back(nullptr, "third");
+        ASSERT_EQUALS(true, &static_cast<const ErrorPath &>(value.errorPath) == path);
+        ASSERT_EQUALS(2U, value.errorPath.size());
+        ASSERT_EQUALS(2U, copy.errorPath.size());
+        ASSERT_EQUALS("second", std::next(copy.errorPath.begin())->second);
+
+        // An assigned empty path reads back empty
+        copy.errorPath = ErrorPath();
+        ASSERT_EQUALS(true, copy.errorPath.empty());
+        ASSERT_EQUALS(0U, copy.errorPath.size());
+        ASSERT_EQUALS(true, copy.errorPath.begin() == copy.errorPath.end());
+        ASSERT_EQUALS(2U, value.errorPath.size());
+        copy.errorPath.emplace_back(nullptr, "fourth");
+        ASSERT_EQUALS(1U, copy.errorPath.size());
+        ASSERT_EQUALS(2U, value.errorPath.size());
+
+        // Assigning a path copies it
+        ErrorPath errorPath;
+        errorPath.emplace_back(nullptr, "fifth");
+        value.errorPath = errorPath;
+        errorPath.clear();
+        ASSERT_EQUALS(1U, value.errorPath.size());
+        ASSERT_EQUALS("fifth", value.errorPath.begin()->second);
+    }
+
     void valueFlowBeforeCondition() {
         const char *code;
 
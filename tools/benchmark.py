@@ -0,0 +1,293 @@
+#!/usr/bin/env python3
+#
+# Benchmark Cppcheck on a fixed local corpus and compare with a baseline.
+#
+# Each corpus entry is checked a few times with --showtime=summary. The
+# timings of the Timer categories (Tokenizer, ValueFlow, checks, ...), the
+# peak memory usage and the size of the input are written to a JSON file.
+# The lexer throughput is the input size divided by the time spent in
+# "Preprocessor::readfile".
+# When a baseline file exists, the results are compared with it and the
+# script fails if a phase got slower than the threshold allows.
+#
+# Usage:
+#   make benchmark                          (or: cmake --build . --target benchmark)
+#   python3 tools/benchmark.py --cppcheck ./cppcheck --output benchmark.json
+#   python3 tools/benchmark.py --cppcheck ./cppcheck --baseline benchmark-baseline.json --update-baseline
+#
+# Compare builds of the same kind only, a debug build is much slower than
+# a release build.
+
+import argparse
+import json
+import os
+import re
+import statistics
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+
+# Phases that take less than this in the baseline, or slowdowns smaller
+# than this, are too noisy to compare
+MIN_SECONDS = 0.01
+
+SOURCE_EXTENSIONS = ('.c', '.cpp', '.cxx', '.cc', '.h', '.hpp')
+
+TOKEN_RE = re.compile(r'"(?:\\.|[^"\\\n])*"|\'(?:\\.|[^\'\\\n])*\'|[A-Za-z_]\w*|\d[\w.]*|::|->|<<=?|>>=?|[-+*/%&|^!=<>]=|&&|\|\||\+\+|--|\S')
+COMMENT_RE = re.compile(r'//[^\n]*|/\*.*?\*/', re.DOTALL)
+
+
+def generate_typedefs(path):
+    with open(path, 'wt') as f:
+        f.write('typedef int T0;\n')
+        for i in range(1, 400):
+            f.write('typedef T%d T%d;\n' % (i - 1, i))
+        for i in range(400):
+            f.write('T%d f%d(T%d x) { T%d y = x + %d; return y; }\n' % (i, i, i, 399 - i, i))
+
+
+def generate_templates(path):
+    with open(path, 'wt') as f:
+        f.write('template<int N> struct Fib { enum { value = Fib<N-1>::value + Fib<N-2>::value }; };\n')
+        f.write('template<> struct Fib<0> { enum { value = 0 }; };\n')
+        f.write('template<> struct Fib<1> { enum { value = 1 }; };\n')
+        f.write('template<class T, int N> struct Array { T data[N]; T get(int i) const { return data[i]; } };\n')
+        for i in range(2, 200):
+            f.write('int fib%d() { return Fib<%d>::value; }\n' % (i, i % 25))
+            f.write('int get%d(const Array<int, %d> &a) { return a.get(%d); }\n' % (i, i, i - 1))
+
+
+def generate_macros(path):
+    with open(path, 'wt') as f:
+        f.write('#define ADD(a, b) ((a) + (b))\n')
+        f.write('#define ADD4(a) ADD(ADD(a, 1), ADD(a, 2))\n')
+        f.write('#define ADD16(a) ADD4(ADD4(a))\n')
+        for i in range(200):
+            f.write('#ifdef CFG%d\n#define V%d %d\n#else\n#define V%d ADD16(%d)\n#endif\n' % (i % 8, i, i, i, i))
+            f.write('int m%d(int x) { return ADD16(x) + V%d; }\n' % (i, i))
+
+
+def generate_initlist(path):
+    # trac #8355: long initializer lists and operator chains in generated code
+    with open(path, 'wt') as f:
+        f.write('struct P { int a; int b; };\n')
+        f.write('P table[] = {\n')
+        for i in range(8000):
+            f.write('    {%d, %d},\n' % (i, i + 1))
+        f.write('};\n')
+        f.write('int sum(int x) {\n    return x')
+        for i in range(2000):
+            f.write(' + %d * x' % i)
+        f.write(';\n}\n')
+
+
+def generate_numeric(path):
+    # numeric tables and constant expressions that are folded by MathLib
+    with open(path, 'wt') as f:
+        f.write('template<int N> struct Pow2 { enum { value = 2 * Pow2<N - 1>::value }; };\n')
+        f.write('template<> struct Pow2<0> { enum { value = 1 }; };\n')
+        f.write('const long long table[] = {\n')
+        for i in range(6000):
+            f.write('    %d * 3 + %d - (%d << 2) / 4, 0x%x | %du, %dLL * %d,\n' % (i, i % 97, i, i, i % 13, i, i % 7))
+        f.write('};\n')
+        for i in range(300):
+            f.write('int p%d() { return Pow2<%d>::value + %d * (%d + 1) - %d %% 7; }\n' % (i, i % 20, i, i, i))
+            f.write('double d%d() { return %d.5 * 2.0 + 1e%d / 3; }\n' % (i, i, i % 10))
+
+
+def generate_lexer(path):
+    # mostly comments, blanks and long identifiers, so the other phases are cheap
+    with open(path, 'wt') as f:
+        for i in range(4000):
+            f.write('/* %s\n * %s */\n' % ('block comment text ' * 4, '*' * 60))
+            f.write('static const int long_identifier_name_number_%d        =  %d;  // %s\n' % (i, i, 'line comment ' * 5))
+            f.write('static const char *s%d = "string literal with some text in it %d";\r\n' % (i, i))
+
+
+GENERATED = (
+    ('stress/typedef.cpp', generate_typedefs),
+    ('stress/template.cpp', generate_templates),
+    ('stress/macro.c', generate_macros),
+    ('stress/initlist.cpp', generate_initlist),
+    ('stress/lexer.c', generate_lexer),
+    ('stress/numeric.cpp', generate_numeric),
+)
+
+
+def corpus(workdir):
+    """Return the (name, path) of the corpus entries"""
+    entries = [('lib', os.path.join(ROOT, 'lib')),
+               ('samples', os.path.join(ROOT, 'samples')),
+               ('synthetic', os.path.join(ROOT, 'test', 'synthetic'))]
+    for name, generator in GENERATED:
+        path = os.path.join(workdir, name)
+        if not os.path.isdir(os.path.dirname(path)):
+            os.makedirs(os.path.dirname(path))
+        generator(path)
+        entries.append((name, path))
+    return entries
+
+
+def source_files(path):
+    if os.path.isfile(path):
+        return [path]
+    ret = []
+    for dirpath, dirnames, filenames in os.walk(path):
+        dirnames.sort()
+        for filename in sorted(filenames):
+            if filename.endswith(SOURCE_EXTENSIONS):
+                ret.append(os.path.join(dirpath, filename))
+    return ret
+
+
+def input_size(path):
+    """Count the files, bytes, lines and tokens of the input, before preprocessing"""
+    files = source_files(path)
+    size = 0
+    lines = 0
+    tokens = 0
+    for filename in files:
+        size += os.path.getsize(filename)
+        with open(filename, 'rt', errors='replace') as f:
+            code = f.read()
+        lines += code.count('\n')
+        tokens += len(TOKEN_RE.findall(COMMENT_RE.sub(' ', code)))
+    return {'files': len(files), 'bytes': size, 'lines': lines, 'tokens': tokens}
+
+
+def run_cppcheck(cppcheck, path, args):
+    """Run Cppcheck once and return the phase timings and the peak RSS in kB"""
+    cmd = [cppcheck, '-q', '--showtime=summary', '--enable=all', '--inconclusive'] + args + [path]
+    p = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, universal_newlines=True)
+    output = p.stdout.read()
+    p.stdout.close()
+    _, status, rusage = os.wait4(p.pid, 0)
+    p.returncode = os.WEXITSTATUS(status) if os.WIFEXITED(status) else -1
+    if p.returncode < 0:
+        sys.exit('cppcheck crashed: ' + ' '.join(cmd))
+
+    phases = {}
+    for line in output.splitlines():
+        res = re.match(r'(.+): ([0-9.e+-]+)s( \(avg\.|$)', line)
+        if res:
+            name = 'Overall' if res.group(1) == 'Overall time' else res.group(1)
+            phases[name] = float(res.group(2))
+    if 'Overall' not in phases:
+        sys.exit('no timing information from: ' + ' '.join(cmd))
+    # ru_maxrss is in kilobytes on Linux and in bytes on macOS
+    maxrss = rusage.ru_maxrss // 1024 if sys.platform == 'darwin' else rusage.ru_maxrss
+    return phases, maxrss
+
+
+def benchmark(cppcheck, entries, runs, args):
+    results = {}
+    for name, path in entries:
+        print('Checking %s (%d runs)' % (name, runs))
+        samples = {}
+        maxrss = 0
+        for _ in range(runs):
+            phases, rss = run_cppcheck(cppcheck, path, args)
+            maxrss = max(maxrss, rss)
+            for phase, seconds in phases.items():
+                samples.setdefault(phase, []).append(seconds)
+        phases = {}
+        for phase, values in samples.items():
+            phases[phase] = {'median': statistics.median(values),
+                             'min': min(values),
+                             'max': max(values)}
+        results[name] = {'phases': phases, 'maxrss_kb': maxrss, 'input': input_size(path)}
+    return results
+
+
+def compare(baseline, results, threshold):
+    """Return the list of regressions against the baseline.
+
+    A phase regresses when its median grows by more than the threshold and
+    the growth is also larger than the spread of the runs in both the
+    baseline and the new results and than MIN_SECONDS, so that noisy
+    phases do not fail."""
+    regressions = []
+    for name, result in sorted(results.items()):
+        base = baseline.get('corpus', {}).get(name)
+        if base is None:
+            continue
+        for phase, new in sorted(result['phases'].items()):
+            old = base['phases'].get(phase)
+            if old is None or old['median'] < MIN_SECONDS:
+                continue
+            growth = new['median'] - old['median']
+            noise = max(old['max'] - old['min'], new['max'] - new['min'], MIN_SECONDS)
+            if growth > old['median'] * threshold and growth > noise:
+                regressions.append('%s: %s %.3fs -> %.3fs (+%.0f%%)' %
+                                   (name, phase, old['median'], new['median'], 100.0 * growth / old['median']))
+        old_rss = base.get('maxrss_kb', 0)
+        if old_rss and result['maxrss_kb'] > old_rss * (1.0 + threshold):
+            regressions.append('%s: peak memory %d kB -> %d kB' % (name, old_rss, result['maxrss_kb']))
+    return regressions
+
+
+def print_summary(results):
+    for name, result in sorted(results.items()):
+        phases = result['phases']
+        print('%-20s %8.3fs %8d kB %8d tokens' % (name, phases['Overall']['median'],
+                                                  result['maxrss_kb'], result['input']['tokens']))
+        readfile = phases.get('Preprocessor::readfile', {}).get('median', 0.0)
+        if readfile > 0.0 and 'bytes' in result['input']:
+            print('    %-50s %8.1f MB/s' % ('lexer throughput', result['input']['bytes'] / readfile / 1e6))
+        top = sorted((p for p in phases if p != 'Overall'), key=lambda p: phases[p]['median'], reverse=True)[:3]
+        for phase in top:
+            print('    %-50s %8.3fs' % (phase, phases[phase]['median']))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Benchmark Cppcheck on a local corpus')
+    parser.add_argument('--cppcheck', default=os.path.join(ROOT, 'cppcheck'), help='cppcheck binary')
+    parser.add_argument('--output', default='benchmark.json', help='file to write the results to')
+    parser.add_argument('--baseline', help='results to compare with')
+    parser.add_argument('--update-baseline', action='store_true', help='write the results to the baseline file')
+    parser.add_argument('--runs', type=int, default=3, help='number of runs per corpus entry')
+    parser.add_argument('--threshold', type=float, default=0.10, help='allowed slowdown, 0.10 is 10%%')
+    parser.add_argument('--corpus', action='append', help='only run these corpus entries')
+    parser.add_argument('--workdir', help='directory for the generated files')
+    parser.add_argument('cppcheck_args', nargs='*', help='extra arguments for cppcheck, after --')
+    args = parser.parse_args()
+
+    workdir = args.workdir or tempfile.mkdtemp(prefix='cppcheck-benchmark-')
+    entries = corpus(workdir)
+    if args.corpus:
+        entries = [e for e in entries if e[0] in args.corpus]
+        if not entries:
+            sys.exit('no corpus entries selected')
+
+    results = benchmark(os.path.abspath(args.cppcheck), entries, max(1, args.runs), args.cppcheck_args)
+    version = subprocess.check_output([args.cppcheck, '--version'], universal_newlines=True).strip()
+    data = {'version': version, 'runs': args.runs, 'corpus': results}
+    with open(args.output, 'wt') as f:
+        json.dump(data, f, indent=1, sort_keys=True)
+    print_summary(results)
+    print('Results written to ' + args.output)
+
+    if not args.baseline:
+        return 0
+    if args.update_baseline or not os.path.isfile(args.baseline):
+        with open(args.baseline, 'wt') as f:
+            json.dump(data, f, indent=1, sort_keys=True)
+        print('Baseline written to ' + args.baseline)
+        return 0
+
+    with open(args.baseline, 'rt') as f:
+        baseline = json.load(f)
+    regressions = compare(baseline, results, args.threshold)
+    if regressions:
+        print('Performance regressions compared to ' + args.baseline + ':')
+        for regression in regressions:
+            print('    ' + regression)
+        return 1
+    print('No regressions compared to ' + args.baseline)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())